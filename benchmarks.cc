@@ -0,0 +1,405 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "lib/s21_gauss_algorithms.h"
+#include "lib/s21_graph_algorithms.h"
+#include "lib/s21_random.h"
+#include "lib/s21_sparse_matrix.h"
+#include "lib/s21_thread_pool.h"
+#include "lib/s21_types.h"
+#include "lib/s21_vinograd_algorithms.h"
+#include "lib/s21_vinograd_batch.h"
+#include "lib/s21_vinograd_kernels.h"
+#include "lib/s21_vinograd_pipeline.h"
+
+namespace s21 {
+
+namespace {
+
+const std::uint64_t kSeed = 42;
+/// @brief ant colony iterations per benchmark iteration
+const std::size_t kSalesmanIterations = 10;
+
+/// @brief 1, 2, 4, ... up to the size of the thread pool
+std::vector<std::int64_t> ThreadCounts() {
+  std::vector<std::int64_t> result;
+  std::int64_t max = ThreadPool::Instance().Size();
+  for (std::int64_t threads = 1; threads < max; threads *= 2) {
+    result.push_back(threads);
+  }
+  result.push_back(max);
+  return result;
+}
+
+/// @brief reports processed items and floating point operations per second
+void SetCounters(benchmark::State &state, double items, double flops) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(items) *
+                          state.iterations());
+  if (flops > 0) {
+    state.counters["GFLOP/s"] = benchmark::Counter(
+        flops * 1e-9 * state.iterations(), benchmark::Counter::kIsRate);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/// @brief args: rows, inner (f_cols_), cols, threads. Shapes are square,
+/// tall, wide and square with odd f_cols_
+template <bool kThreaded> void VinogradArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"rows", "inner", "cols", "threads"});
+  auto threads = kThreaded ? ThreadCounts() : std::vector<std::int64_t>{1};
+  for (std::int64_t n : {64, 256, 512}) {
+    for (auto t : threads) {
+      b->Args({n, n, n, t});
+      b->Args({4 * n, n, n / 4, t});
+      b->Args({n / 4, n, 4 * n, t});
+      b->Args({n, n + 1, n, t});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <typename Engine> void BM_Vinograd(benchmark::State &state) {
+  std::size_t rows = state.range(0);
+  std::size_t inner = state.range(1);
+  std::size_t cols = state.range(2);
+  std::size_t threads = state.range(3);
+  auto first = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed).Generate(rows, inner));
+  auto second = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed + 1).Generate(inner, cols));
+  auto result = std::make_shared<m_dbl_type>(rows, cols);
+
+  std::unique_ptr<Engine> engine;
+  if constexpr (std::is_same_v<Engine, ParallelVinograd> ||
+                std::is_same_v<Engine, PipeVinograd>) {
+    engine = std::make_unique<Engine>(first, second, result, threads);
+  } else {
+    engine = std::make_unique<Engine>(first, second, result);
+  }
+  for (auto _ : state) {
+    engine->Multiply();
+    benchmark::DoNotOptimize(result->data());
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, double(rows) * cols, 2.0 * rows * inner * cols);
+}
+
+BENCHMARK_TEMPLATE(BM_Vinograd, SimpleVinograd)->Apply(VinogradArgs<false>);
+BENCHMARK_TEMPLATE(BM_Vinograd, ParallelVinograd)->Apply(VinogradArgs<true>);
+BENCHMARK_TEMPLATE(BM_Vinograd, PipeVinograd)->Apply(VinogradArgs<true>);
+BENCHMARK_TEMPLATE(BM_Vinograd, BlockedVinograd)->Apply(VinogradArgs<false>);
+BENCHMARK_TEMPLATE(BM_Vinograd, StrassenVinograd)->Apply(VinogradArgs<false>);
+
+/// @brief pairs multiplied per benchmark iteration by streaming benchmarks
+const std::size_t kStreamPairs = 16;
+
+/// @brief args: size, threads. Items are multiplied pairs
+void StreamArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "threads"});
+  for (std::int64_t n : {64, 256}) {
+    for (auto t : ThreadCounts()) {
+      b->Args({n, t});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+/// @brief kStreamPairs pairs of the same shape one after another, the
+/// baseline for BM_VinogradPipeline
+void BM_VinogradStreamLoop(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  auto first = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed).Generate(n, n));
+  auto second = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed + 1).Generate(n, n));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kStreamPairs; ++i) {
+      auto result = std::make_shared<m_dbl_type>(n, n);
+      ParallelVinograd(first, second, result, threads).Multiply();
+      benchmark::DoNotOptimize(result->data());
+    }
+  }
+  SetCounters(state, kStreamPairs, 2.0 * kStreamPairs * n * n * n);
+}
+
+void BM_VinogradPipeline(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  auto first = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed).Generate(n, n));
+  auto second = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed + 1).Generate(n, n));
+
+  for (auto _ : state) {
+    VinogradPipeline pipeline(
+        [](std::size_t, m_dbl_type result) {
+          benchmark::DoNotOptimize(result.data());
+        },
+        threads);
+    for (std::size_t i = 0; i < kStreamPairs; ++i) {
+      pipeline.Submit(first, second);
+    }
+    pipeline.Finish();
+  }
+  SetCounters(state, kStreamPairs, 2.0 * kStreamPairs * n * n * n);
+}
+
+/// @brief kStreamPairs different inputs by one shared weight matrix
+void BM_VinogradBatch(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  auto weights = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed).Generate(n, n));
+  std::vector<const_m_ptr> inputs;
+  for (std::size_t i = 0; i < kStreamPairs; ++i) {
+    inputs.push_back(std::make_shared<const m_dbl_type>(
+        MatrixGenerator(kSeed + 1 + i).Generate(n, n)));
+  }
+
+  BatchVinograd engine(weights);
+  for (auto _ : state) {
+    auto results = engine.MultiplyBatch(inputs, threads);
+    benchmark::DoNotOptimize(results.data());
+  }
+  SetCounters(state, kStreamPairs, 2.0 * kStreamPairs * n * n * n);
+}
+
+BENCHMARK(BM_VinogradStreamLoop)->Apply(StreamArgs);
+BENCHMARK(BM_VinogradPipeline)->Apply(StreamArgs);
+BENCHMARK(BM_VinogradBatch)->Apply(StreamArgs);
+
+/// @brief args: size, instruction set of kernels (SimdLevel)
+void SimdArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "simd"});
+  for (std::int64_t n : {256, 512}) {
+    for (auto level : SupportedSimdLevels()) {
+      b->Args({n, static_cast<std::int64_t>(level)});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <typename Engine> void BM_VinogradSimd(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  auto level = static_cast<SimdLevel>(state.range(1));
+  auto first = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed).Generate(n, n));
+  auto second = std::make_shared<const m_dbl_type>(
+      MatrixGenerator(kSeed + 1).Generate(n, n));
+  auto result = std::make_shared<m_dbl_type>(n, n);
+
+  Engine engine(first, second, result);
+  engine.SetKernels(GetVinogradKernels(level));
+  state.SetLabel(SimdLevelName(level));
+  for (auto _ : state) {
+    engine.Multiply();
+    benchmark::DoNotOptimize(result->data());
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, double(n) * n, 2.0 * n * n * n);
+}
+
+BENCHMARK_TEMPLATE(BM_VinogradSimd, SimpleVinograd)->Apply(SimdArgs);
+BENCHMARK_TEMPLATE(BM_VinogradSimd, BlockedVinograd)->Apply(SimdArgs);
+
+/// @brief args: size, threads
+void ElementArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "threads"});
+  for (std::int64_t n : {256, 512}) {
+    for (auto t : ThreadCounts()) {
+      b->Args({n, t});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <typename T> void BM_VinogradElement(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  m_dbl_type values = MatrixGenerator(kSeed).Generate(n, 2 * n);
+  auto first = std::make_shared<Matrix<T>>(n, n);
+  auto second = std::make_shared<Matrix<T>>(n, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      (*first)(i, j) = static_cast<T>(values(i, j));
+      (*second)(i, j) = static_cast<T>(values(i, n + j));
+    }
+  }
+  auto result = std::make_shared<Matrix<T>>(n, n);
+
+  BasicParallelVinograd<T> engine(first, second, result, threads);
+  for (auto _ : state) {
+    engine.Multiply();
+    benchmark::DoNotOptimize(result->data());
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, double(n) * n, 2.0 * n * n * n);
+}
+
+BENCHMARK_TEMPLATE(BM_VinogradElement, float)->Apply(ElementArgs);
+BENCHMARK_TEMPLATE(BM_VinogradElement, double)->Apply(ElementArgs);
+BENCHMARK_TEMPLATE(BM_VinogradElement, std::int64_t)->Apply(ElementArgs);
+
+/// @brief args: size, nonzeros per thousand elements, threads
+void SparseArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "permille", "threads"});
+  for (std::int64_t n : {512, 1024}) {
+    for (std::int64_t permille : {10, 50}) {
+      for (auto t : ThreadCounts()) {
+        b->Args({n, permille, t});
+      }
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+/// @brief matrix with about "permille" nonzeros per thousand elements
+m_dbl_type SparseMatrix(std::size_t n, std::size_t permille,
+                        std::uint64_t seed) {
+  m_dbl_type matrix = MatrixGenerator(seed).Generate(n, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      // values are uniform in [0, 1)
+      if (matrix(i, j) >= permille / 1000.0) {
+        matrix(i, j) = 0.0;
+      }
+    }
+  }
+  return matrix;
+}
+
+template <typename Engine> void BM_VinogradSparse(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t permille = state.range(1);
+  std::size_t threads = state.range(2);
+  auto first = std::make_shared<const m_dbl_type>(
+      SparseMatrix(n, permille, kSeed));
+  auto second = std::make_shared<const m_dbl_type>(
+      SparseMatrix(n, permille, kSeed + 1));
+  auto result = std::make_shared<m_dbl_type>(n, n);
+
+  std::unique_ptr<Engine> engine;
+  if constexpr (std::is_same_v<Engine, SparseVinograd>) {
+    engine = std::make_unique<Engine>(first, second, result, threads);
+  } else {
+    engine = std::make_unique<Engine>(first, second, result);
+  }
+  for (auto _ : state) {
+    engine->Multiply();
+    benchmark::DoNotOptimize(result->data());
+  }
+  SetCounters(state, double(n) * n, 2.0 * n * n * n);
+}
+
+BENCHMARK_TEMPLATE(BM_VinogradSparse, SparseVinograd)->Apply(SparseArgs);
+BENCHMARK_TEMPLATE(BM_VinogradSparse, BlockedVinograd)->Apply(SparseArgs);
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/// @brief args: equations, threads
+template <bool kThreaded> void GaussArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "threads"});
+  auto threads = kThreaded ? ThreadCounts() : std::vector<std::int64_t>{1};
+  for (std::int64_t n : {64, 256, 512}) {
+    for (auto t : threads) {
+      b->Args({n, t});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <typename Engine> void BM_Gauss(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  auto matrix = std::make_shared<m_dbl_type>(
+      MatrixGenerator(kSeed).DiagonallyDominant(n));
+  auto result = std::make_shared<row_type>(n + 1, 1.0);
+
+  std::unique_ptr<Engine> engine;
+  if constexpr (std::is_same_v<Engine, ParallelGauss> ||
+                std::is_same_v<Engine, BlockedGauss> ||
+                std::is_same_v<Engine, TiledGauss>) {
+    engine = std::make_unique<Engine>(matrix, result, threads);
+  } else {
+    engine = std::make_unique<Engine>(matrix, result);
+  }
+  for (auto _ : state) {
+    engine->SolveSle();
+    benchmark::DoNotOptimize(result->data());
+  }
+  SetCounters(state, double(n), 2.0 / 3.0 * n * n * n);
+}
+
+BENCHMARK_TEMPLATE(BM_Gauss, SimpleGauss)->Apply(GaussArgs<false>);
+BENCHMARK_TEMPLATE(BM_Gauss, ParallelGauss)->Apply(GaussArgs<true>);
+BENCHMARK_TEMPLATE(BM_Gauss, BlockedGauss)->Apply(GaussArgs<true>);
+BENCHMARK_TEMPLATE(BM_Gauss, TiledGauss)->Apply(GaussArgs<true>);
+
+/// @brief items are right-hand sides solved with kept factors
+void BM_GaussSolveMany(benchmark::State &state) {
+  constexpr std::size_t kRhs = 64;
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  auto matrix = std::make_shared<m_dbl_type>(
+      MatrixGenerator(kSeed).DiagonallyDominant(n));
+  auto result = std::make_shared<row_type>(n + 1, 1.0);
+  m_dbl_type rhs = MatrixGenerator(kSeed + 1).Generate(n, kRhs);
+  m_dbl_type solutions(n, kRhs);
+
+  BlockedGauss engine(matrix, result, threads);
+  engine.Factor();
+  for (auto _ : state) {
+    engine.Solve(rhs, solutions);
+    benchmark::DoNotOptimize(solutions.data());
+  }
+  SetCounters(state, double(kRhs), 2.0 * kRhs * n * n);
+}
+
+BENCHMARK(BM_GaussSolveMany)->Apply(GaussArgs<true>);
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/// @brief args: vertices, threads. Items are ant colony iterations
+void SalesmanArgs(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "threads"});
+  for (std::int64_t n : {16, 64}) {
+    for (auto t : ThreadCounts()) {
+      b->Args({n, t});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void BM_LinearSolver(benchmark::State &state) {
+  std::size_t n = state.range(0);
+  std::size_t threads = state.range(1);
+  MatrixGenerator generator(kSeed);
+  generator.SetDistribution(MatrixGenerator::Distribution::kUniform, 1, 100);
+  auto matrix =
+      std::make_shared<const m_dbl_type>(generator.SymmetricWeights(n));
+
+  for (auto _ : state) {
+    LinearSolver solver(matrix, std::make_shared<TsmResult>());
+    solver.SolveSalesman(kSalesmanIterations, threads);
+  }
+  SetCounters(state, kSalesmanIterations, 0);
+}
+
+BENCHMARK(BM_LinearSolver)->Apply(SalesmanArgs);
+
+} // namespace
+
+} // namespace s21
+
+BENCHMARK_MAIN();
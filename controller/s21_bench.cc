@@ -0,0 +1,285 @@
+#include "s21_bench.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace s21 {
+
+namespace {
+
+std::vector<std::string> Split(const std::string &text, char delimiter) {
+  std::vector<std::string> result;
+  std::istringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, delimiter)) {
+    result.push_back(item);
+  }
+  return result;
+}
+
+std::size_t ToSize(const std::string &text) {
+  std::size_t pos = 0;
+  unsigned long long value = 0;
+  try {
+    value = std::stoull(text, &pos);
+  } catch (...) {
+    pos = 0;
+  }
+  if (pos == 0 || pos != text.size() || text.front() == '-') {
+    throw std::invalid_argument("bench: wrong number '" + text + "'");
+  }
+  return value;
+}
+
+std::vector<std::size_t> ParseList(const std::string &text) {
+  std::vector<std::size_t> result;
+  for (auto &item : Split(text, ',')) {
+    result.push_back(ToSize(item));
+  }
+  return result;
+}
+
+/// @brief "a:b:xk" - a, a*k, ... up to b; "a:b:+k" - a, a+k, ... up to b;
+/// otherwise comma-separated list
+std::vector<std::size_t> ParseSizes(const std::string &text) {
+  auto parts = Split(text, ':');
+  if (parts.size() == 1) {
+    return ParseList(text);
+  }
+  if (parts.size() != 3 || parts[2].size() < 2 ||
+      (parts[2][0] != 'x' && parts[2][0] != '+')) {
+    throw std::invalid_argument("bench: wrong range '" + text + "'");
+  }
+  std::size_t first = ToSize(parts[0]);
+  std::size_t last = ToSize(parts[1]);
+  std::size_t step = ToSize(parts[2].substr(1));
+  bool geometric = parts[2][0] == 'x';
+  if (first == 0 || step < (geometric ? 2u : 1u)) {
+    throw std::invalid_argument("bench: wrong range '" + text + "'");
+  }
+  std::vector<std::size_t> result;
+  for (std::size_t size = first; size <= last;
+       size = geometric ? size * step : size + step) {
+    result.push_back(size);
+  }
+  return result;
+}
+
+Storage::MultiMode ParseMode(const std::string &text) {
+  if (text == "simple") {
+    return Storage::MultiMode::kSimple;
+  } else if (text == "parallel") {
+    return Storage::MultiMode::kParallel;
+  } else if (text == "pipe") {
+    return Storage::MultiMode::kPipe;
+  } else if (text == "blocked") {
+    return Storage::MultiMode::kBlocked;
+  } else if (text == "strassen") {
+    return Storage::MultiMode::kStrassen;
+  } else if (text == "sparse") {
+    return Storage::MultiMode::kSparse;
+  } else if (text == "tiled") {
+    return Storage::MultiMode::kTiled;
+  } else if (text == "auto") {
+    return Storage::MultiMode::kAuto;
+  }
+  throw std::invalid_argument("bench: unknown mode '" + text + "'");
+}
+
+BenchConfig::Algorithm ParseAlgorithm(const std::string &text) {
+  if (text == "vinograd") {
+    return BenchConfig::Algorithm::kVinograd;
+  } else if (text == "gauss") {
+    return BenchConfig::Algorithm::kGauss;
+  } else if (text == "salesman") {
+    return BenchConfig::Algorithm::kSalesman;
+  }
+  throw std::invalid_argument("bench: unknown algorithm '" + text + "'");
+}
+
+std::string EscapeJson(const std::string &text) {
+  std::string result;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result;
+}
+
+} // namespace
+
+BenchConfig BenchConfig::Parse(int argc, const char *const *argv) {
+  BenchConfig config;
+  for (int i = 0; i < argc; ++i) {
+    std::string option = argv[i];
+    if (i + 1 >= argc) {
+      throw std::invalid_argument("bench: no value for '" + option + "'");
+    }
+    std::string value = argv[++i];
+    if (option == "--algo") {
+      config.algorithm = ParseAlgorithm(value);
+    } else if (option == "--mode") {
+      config.modes.clear();
+      for (auto &item : Split(value, ',')) {
+        config.modes.push_back(ParseMode(item));
+      }
+    } else if (option == "--sizes") {
+      config.sizes = ParseSizes(value);
+    } else if (option == "--threads") {
+      config.threads = ParseList(value);
+    } else if (option == "--reps") {
+      config.reps = ToSize(value);
+    } else if (option == "--iters") {
+      config.iterations = ToSize(value);
+    } else if (option == "--seed") {
+      config.seed = ToSize(value);
+    } else if (option == "--format") {
+      if (value != "csv" && value != "json") {
+        throw std::invalid_argument("bench: unknown format '" + value + "'");
+      }
+      config.format = (value == "csv") ? Format::kCsv : Format::kJson;
+    } else if (option == "--output") {
+      config.output = value;
+    } else if (option == "--affinity") {
+      config.affinity = value;
+    } else if (option == "--tiles") {
+      auto tiles = ParseList(value);
+      if (tiles.size() != 3) {
+        throw std::invalid_argument("bench: --tiles needs rows,cols,pairs");
+      }
+      config.tiles = {tiles[0], tiles[1], tiles[2]};
+    } else if (option == "--cutoff") {
+      config.cutoff = ToSize(value);
+    } else if (option == "--block") {
+      config.block = ToSize(value);
+    } else if (option == "--tile") {
+      config.tile = ToSize(value);
+    } else if (option == "--trace") {
+      config.trace = value;
+    } else {
+      throw std::invalid_argument("bench: unknown option '" + option + "'");
+    }
+  }
+
+  if (config.modes.empty()) {
+    config.modes = {Storage::MultiMode::kSimple, Storage::MultiMode::kParallel};
+  }
+  bool unsupported = std::any_of(
+      config.modes.begin(), config.modes.end(),
+      [&config](Storage::MultiMode mode) {
+        if (mode == Storage::MultiMode::kSimple ||
+            mode == Storage::MultiMode::kParallel) {
+          return false;
+        }
+        if (config.algorithm == Algorithm::kVinograd) {
+          return mode == Storage::MultiMode::kTiled;
+        }
+        return config.algorithm != Algorithm::kGauss ||
+               (mode != Storage::MultiMode::kBlocked &&
+                mode != Storage::MultiMode::kTiled);
+      });
+  if (unsupported) {
+    throw std::invalid_argument("bench: mode is not supported by algorithm");
+  }
+  if (config.sizes.empty()) {
+    config.sizes = {256};
+  }
+  if (config.threads.empty()) {
+    config.threads = {0};
+  }
+  if (config.reps == 0) {
+    throw std::invalid_argument("bench: --reps must be positive");
+  }
+  return config;
+}
+
+std::string BenchConfig::Usage() {
+  return "usage: Parallels bench [options]\n"
+         "  --algo vinograd|gauss|salesman  algorithm (vinograd)\n"
+         "  --mode simple,parallel,pipe,blocked,strassen,sparse,tiled,auto\n"
+         "                                  modes to run (simple,parallel)\n"
+         "  --sizes 256:4096:x2|64:512:+64|100,200\n"
+         "                                  matrix sizes (256)\n"
+         "  --threads 1,2,4                 threads of parallel and strassen "
+         "modes,\n"
+         "                                  0 - pool size (0)\n"
+         "  --reps N                        runs of every case (5)\n"
+         "  --iters N                       salesman iterations (100)\n"
+         "  --seed N                        seed of input matrices (42)\n"
+         "  --format csv|json               output format (csv)\n"
+         "  --output FILE                   output file (stdout)\n"
+         "  --affinity compact|scatter[:nosmt]\n"
+         "                                  pinning of pool workers\n"
+         "  --tiles rows,cols,pairs         blocks of blocked mode, 0 - "
+         "from caches\n"
+         "  --cutoff N                      recursion cutoff of strassen "
+         "mode (512)\n"
+         "  --block N                       panel of gauss blocked mode "
+         "(64)\n"
+         "  --tile N                        tile of gauss tiled mode (64)\n"
+         "  --trace FILE                    Chrome trace of algorithm phases\n";
+}
+
+void WriteBenchRecords(const std::vector<BenchRecord> &records,
+                       BenchConfig::Format format, std::ostream &out) {
+  if (format == BenchConfig::Format::kCsv) {
+    out << "algo,mode,size,threads,rep,time_us\n";
+    for (auto &record : records) {
+      out << record.algorithm << ',' << record.mode << ',' << record.size
+          << ',' << record.threads << ',' << record.rep << ','
+          << record.time_us << '\n';
+    }
+    return;
+  }
+
+  out << "[";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    auto &record = records[i];
+    out << (i ? ",\n " : "\n ") << "{\"algo\": \""
+        << EscapeJson(record.algorithm) << "\", \"mode\": \""
+        << EscapeJson(record.mode) << "\", \"size\": " << record.size
+        << ", \"threads\": " << record.threads << ", \"rep\": " << record.rep
+        << ", \"time_us\": " << record.time_us << "}";
+  }
+  out << "\n]\n";
+}
+
+std::string BenchModeName(Storage::MultiMode mode) {
+  switch (mode) {
+  case Storage::MultiMode::kSimple:
+    return "simple";
+  case Storage::MultiMode::kParallel:
+    return "parallel";
+  case Storage::MultiMode::kPipe:
+    return "pipe";
+  case Storage::MultiMode::kBlocked:
+    return "blocked";
+  case Storage::MultiMode::kStrassen:
+    return "strassen";
+  case Storage::MultiMode::kSparse:
+    return "sparse";
+  case Storage::MultiMode::kTiled:
+    return "tiled";
+  case Storage::MultiMode::kAuto:
+    return "auto";
+  default:
+    return "unknown";
+  }
+}
+
+std::string BenchAlgorithmName(BenchConfig::Algorithm algorithm) {
+  switch (algorithm) {
+  case BenchConfig::Algorithm::kVinograd:
+    return "vinograd";
+  case BenchConfig::Algorithm::kGauss:
+    return "gauss";
+  default:
+  case BenchConfig::Algorithm::kSalesman:
+    return "salesman";
+  }
+}
+
+} // namespace s21
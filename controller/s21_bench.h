@@ -0,0 +1,83 @@
+#ifndef PARALLELS_SRC_CONTROLLER_S21_BENCH_H_
+#define PARALLELS_SRC_CONTROLLER_S21_BENCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../lib/s21_storage.h"
+
+namespace s21 {
+
+/// @brief settings of non-interactive benchmark mode:
+/// Parallels bench --algo vinograd --mode simple,parallel,pipe
+///                 --sizes 256:4096:x2 --threads 1,2,4,8 --reps 10
+struct BenchConfig {
+  enum class Algorithm { kVinograd, kGauss, kSalesman };
+  enum class Format { kCsv, kJson };
+
+  Algorithm algorithm = Algorithm::kVinograd;
+  std::vector<Storage::MultiMode> modes;
+  std::vector<std::size_t> sizes;
+  /// @brief thread counts for parallel and strassen modes (other modes run
+  /// once with 1)
+  std::vector<std::size_t> threads;
+  std::size_t reps = 5;
+  /// @brief iterations of the ant colony algorithm per run
+  std::size_t iterations = 100;
+  std::uint64_t seed = 42;
+  Format format = Format::kCsv;
+  /// @brief path to the output file, empty - standard output
+  std::string output;
+  /// @brief placement of pool workers, empty - S21_AFFINITY or no pinning
+  std::string affinity;
+  /// @brief blocks of blocked mode, 0 - derived from cache sizes
+  BlockedVinograd::Tiles tiles;
+  /// @brief cutoff of strassen mode
+  std::size_t cutoff = StrassenVinograd::kDefaultCutoff;
+  /// @brief panel of gauss blocked mode, 0 - BlockedGauss::kDefaultBlock
+  std::size_t block = 0;
+  /// @brief tile of gauss tiled mode, 0 - TiledGauss::kDefaultTile
+  std::size_t tile = 0;
+  /// @brief path to Chrome trace of algorithm phases, empty - no tracing
+  std::string trace;
+
+  /// @brief parses command line arguments following "bench"
+  /// @param argc number of arguments
+  /// @param argv arguments
+  /// @return parsed settings; defaults are filled for missing options
+  /// @throw std::invalid_argument if an option is unknown or malformed
+  static BenchConfig Parse(int argc, const char *const *argv);
+
+  /// @brief usage message
+  static std::string Usage();
+};
+
+/// @brief timing of one run
+struct BenchRecord {
+  std::string algorithm;
+  std::string mode;
+  std::size_t size = 0;
+  std::size_t threads = 0;
+  std::size_t rep = 0;
+  long long time_us = 0;
+};
+
+/// @brief writes records as CSV (with header) or JSON array
+/// @param records timings
+/// @param format kCsv or kJson
+/// @param out output stream
+void WriteBenchRecords(const std::vector<BenchRecord> &records,
+                       BenchConfig::Format format, std::ostream &out);
+
+/// @brief name of mode used in reports ("simple", "parallel", "pipe")
+std::string BenchModeName(Storage::MultiMode mode);
+
+/// @brief name of algorithm used in reports ("vinograd", "gauss", ...)
+std::string BenchAlgorithmName(BenchConfig::Algorithm algorithm);
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_CONTROLLER_S21_BENCH_H_
@@ -7,6 +7,9 @@
 #include <string>
 #include <thread>
 
+#include "../lib/s21_random.h"
+#include "../lib/s21_thread_pool.h"
+
 namespace s21 {
 
 Controller::Controller(std::shared_ptr<ConsoleView> view) : view_(view) {
@@ -82,6 +85,97 @@ void Controller::ReceiveSignal(int choice,
   view_->GetString("Введите любой символ для продолжения.");
 }
 
+// BENCHMARK FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<BenchRecord>
+Controller::RunBenchmark(const BenchConfig &config) const {
+  std::vector<BenchRecord> records;
+  const std::string algorithm = BenchAlgorithmName(config.algorithm);
+
+  // prepare(mode, threads) sets up the storage, compute(threads) performs
+  // one timed run and returns its duration
+  auto run_cases = [&](std::size_t size, auto prepare, auto compute) {
+    for (auto mode : config.modes) {
+      bool threaded = mode == Storage::MultiMode::kParallel ||
+                      mode == Storage::MultiMode::kPipe ||
+                      mode == Storage::MultiMode::kStrassen ||
+                      mode == Storage::MultiMode::kSparse ||
+                      mode == Storage::MultiMode::kAuto ||
+                      (config.algorithm == BenchConfig::Algorithm::kGauss &&
+                       (mode == Storage::MultiMode::kBlocked ||
+                        mode == Storage::MultiMode::kTiled));
+      auto threads_list =
+          threaded ? config.threads : std::vector<std::size_t>{1};
+      for (auto threads : threads_list) {
+        if (threads > Storage::MaxThreadCount()) {
+          std::cerr << "bench: " << threads << " threads skipped, at most "
+                    << Storage::MaxThreadCount() << " are supported\n";
+          continue;
+        }
+        threads = threads ? threads : ThreadPool::Instance().Size();
+        prepare(mode, threads);
+        for (std::size_t rep = 0; rep < config.reps; ++rep) {
+          records.push_back({algorithm, BenchModeName(mode), size, threads,
+                             rep, std::stoll(compute(threads))});
+        }
+      }
+    }
+  };
+
+  MatrixGenerator first(config.seed);
+  MatrixGenerator second(config.seed + 1);
+  for (auto size : config.sizes) {
+    switch (config.algorithm) {
+    case BenchConfig::Algorithm::kVinograd: {
+      VinogradStorage storage(first.Generate(size, size),
+                              second.Generate(size, size));
+      storage.SetTiles(config.tiles);
+      storage.SetStrassenCutoff(config.cutoff);
+      run_cases(
+          size,
+          [&storage](Storage::MultiMode mode, std::size_t threads) {
+            storage.SetThreadCount(threads);
+            storage.SetStrategy(mode);
+          },
+          [this, &storage](std::size_t) {
+            return TimeVinograd(storage, 1);
+          });
+      break;
+    }
+    case BenchConfig::Algorithm::kGauss: {
+      GaussStorage storage(first.DiagonallyDominant(size));
+      storage.SetBlock(config.block);
+      storage.SetTile(config.tile);
+      run_cases(
+          size,
+          [&storage](Storage::MultiMode mode, std::size_t threads) {
+            storage.SetThreadCount(threads);
+            storage.SetStrategy(mode);
+          },
+          [this, &storage](std::size_t) {
+            return TimeGauss(storage, 1);
+          });
+      break;
+    }
+    case BenchConfig::Algorithm::kSalesman: {
+      MatrixGenerator weights(config.seed);
+      weights.SetDistribution(MatrixGenerator::Distribution::kUniform, 1, 100);
+      SalesmanStorage storage(weights.SymmetricWeights(size));
+      run_cases(
+          size,
+          [&storage](Storage::MultiMode mode, std::size_t) {
+            storage.SetStrategy(mode);
+          },
+          [this, &storage, &config](std::size_t threads) {
+            return ComputeSalesman(storage, config.iterations, threads).second;
+          });
+      break;
+    }
+    }
+  }
+  return records;
+}
+
 // SALESMAN FUNCTIONS
 /////////////////////////////////////////////////////////////////////////////////////////////
 void Controller::SolveSalesman() {
@@ -162,9 +256,12 @@ void Controller::MultiplyByVinograd() {
     return;
   }
   auto threads_count = view_->GetThreadsCount();
+  if (threads_count == 0) {
+    return;
+  }
   MultiplyVinoSimple(new_storage, count);
   MultiplyVinoParallel(new_storage, count, threads_count);
-  MultiplyVinoPipe(new_storage, count);
+  MultiplyVinoPipe(new_storage, count, threads_count);
 }
 
 void Controller::MultiplyVinoSimple(VinogradStorage &storage,
@@ -192,9 +289,10 @@ void Controller::MultiplyVinoParallel(VinogradStorage &storage, const int count,
   }
 }
 
-void Controller::MultiplyVinoPipe(VinogradStorage &storage,
-                                  const int count) const {
+void Controller::MultiplyVinoPipe(VinogradStorage &storage, const int count,
+                                  const int threads) const {
   try {
+    storage.SetThreadCount(threads);
     storage.SetStrategy(Storage::MultiMode::kPipe);
     view_->ShowMsg("\nPipe mode:\n");
     OutputVinogradResult(ComputeVinograd(storage, count));
@@ -205,8 +303,15 @@ void Controller::MultiplyVinoPipe(VinogradStorage &storage,
 }
 
 std::pair<m_dbl_type, std::string>
-Controller::ComputeVinograd(VinogradStorage new_storage,
+Controller::ComputeVinograd(VinogradStorage &new_storage,
                             std::size_t count) const {
+  std::string duration = TimeVinograd(new_storage, count);
+  return std::pair<m_dbl_type, std::string>(new_storage.TakeResult(),
+                                            duration);
+}
+
+std::string Controller::TimeVinograd(VinogradStorage &new_storage,
+                                     std::size_t count) const {
   auto start = std::chrono::high_resolution_clock::now();
   for (size_t i = 0; i < count; ++i) {
     new_storage.Multiply();
@@ -214,13 +319,12 @@ Controller::ComputeVinograd(VinogradStorage new_storage,
   auto stop = std::chrono::high_resolution_clock::now();
   auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-  return std::pair<m_dbl_type, std::string>(new_storage.GetResult(),
-                                            std::to_string(duration.count()));
+  return std::to_string(duration.count());
 }
 
 void Controller::OutputVinogradResult(
-    std::pair<m_dbl_type, std::string> buff) const {
-  auto [matr, buff_time] = buff;
+    const std::pair<m_dbl_type, std::string> &buff) const {
+  const auto &[matr, buff_time] = buff;
   view_->ShowMsg("Результат перемножения:");
   view_->ShowMatrix(matr);
   view_->ShowMsg("Время выполнения (мс): ");
@@ -269,7 +373,13 @@ void Controller::SolveGaussSleParallel(GaussStorage &storage, const int count,
 }
 
 std::pair<row_type, std::string>
-Controller::ComputeGauss(GaussStorage new_storage, std::size_t count) const {
+Controller::ComputeGauss(GaussStorage &new_storage, std::size_t count) const {
+  std::string duration = TimeGauss(new_storage, count);
+  return std::pair<row_type, std::string>(new_storage.GetResult(), duration);
+}
+
+std::string Controller::TimeGauss(GaussStorage &new_storage,
+                                  std::size_t count) const {
   auto start = std::chrono::high_resolution_clock::now();
   for (size_t i = 0; i < count; ++i) {
     new_storage.SolveSle();
@@ -277,8 +387,7 @@ Controller::ComputeGauss(GaussStorage new_storage, std::size_t count) const {
   auto stop = std::chrono::high_resolution_clock::now();
   auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-  return std::pair<row_type, std::string>(new_storage.GetResult(),
-                                          std::to_string(duration.count()));
+  return std::to_string(duration.count());
 }
 
 void Controller::OutputGaussResult(
@@ -1,9 +1,12 @@
 #ifndef PARALLELS_SRC_CONTROLLER_CONTROLLER_H_
 #define PARALLELS_SRC_CONTROLLER_CONTROLLER_H_
 
+#include <vector>
+
 #include "../lib/s21_storage.h"
 #include "../lib/s21_types.h"
 #include "../view/s21_console_view.h"
+#include "s21_bench.h"
 
 namespace s21 {
 
@@ -25,6 +28,12 @@ public:
   /// @param solveFunction function to be called (SolveSalesman,
   /// MultiplyByVinograd, etc)
   void ReceiveSignal(int choice, void (Controller::*solveFunction)());
+  /// @brief runs benchmark without user interaction. Inputs are generated
+  /// from the seed, every case is timed by the same Compute* functions as
+  /// the menu, one computation per run
+  /// @param config benchmark settings
+  /// @return timings of every run
+  std::vector<BenchRecord> RunBenchmark(const BenchConfig &config) const;
 
 private:
   std::shared_ptr<ConsoleView> view_;
@@ -79,18 +88,25 @@ private:
   /// @param storage storage for input data, result and sandbox for operating
   /// with them.
   /// @param count count of multiplications
-  void MultiplyVinoPipe(VinogradStorage &storage, const int count) const;
+  /// @param threads number of threads of the main loop
+  void MultiplyVinoPipe(VinogradStorage &storage, const int count,
+                        const int threads) const;
   /// @brief wrapper for solving and duration measurement
   /// @param storage storage for input data, result and sandbox for operating
   /// with them.
   /// @param count count of multiplications
   /// @return pair of result and duration
-  std::pair<m_dbl_type, std::string> ComputeVinograd(VinogradStorage storage,
+  std::pair<m_dbl_type, std::string> ComputeVinograd(VinogradStorage &storage,
                                                      size_t count) const;
+  /// @brief multiplies "count" times, the result stays in the storage (bench
+  /// runs do not move it out, so the next run reuses its buffer)
+  /// @return duration
+  std::string TimeVinograd(VinogradStorage &storage, size_t count) const;
   /// @brief operates by view and outputs the Salesman result in apporpriate
   /// format
   /// @param result pair of result and duration
-  void OutputVinogradResult(std::pair<m_dbl_type, std::string> result) const;
+  void
+  OutputVinogradResult(const std::pair<m_dbl_type, std::string> &result) const;
   /// @brief launches Gaussian equations solving 2 times - linear and parallel
   void SolveGaussSle();
   /// @brief solves linear Gaussian equation linear
@@ -109,8 +125,11 @@ private:
   /// with them.
   /// @param count count of multiplications
   /// @return pair of result and duration
-  std::pair<row_type, std::string> ComputeGauss(GaussStorage storage,
+  std::pair<row_type, std::string> ComputeGauss(GaussStorage &storage,
                                                 size_t count) const;
+  /// @brief solves "count" times, the result stays in the storage
+  /// @return duration
+  std::string TimeGauss(GaussStorage &storage, size_t count) const;
   /// @brief operates by view and outputs the Salesman result in apporpriate
   /// format
   /// @param result pair of result and duration
@@ -0,0 +1,100 @@
+#ifndef PARALLELS_SRC_LIB_S21_BOUNDED_QUEUE_H_
+#define PARALLELS_SRC_LIB_S21_BOUNDED_QUEUE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace s21 {
+
+/// @brief blocking FIFO queue of limited capacity connecting stages of a
+/// pipeline. Push blocks while the queue is full, so a fast stage can not
+/// run ahead of a slow one by more than "capacity" items. After Close the
+/// remaining items can still be popped.
+template <typename T> class BoundedQueue {
+public:
+  /// @brief ctor
+  /// @param capacity largest number of queued items, at least 1
+  explicit BoundedQueue(std::size_t capacity)
+      : capacity_(std::max<std::size_t>(capacity, 1)){};
+  BoundedQueue(const BoundedQueue &other) = delete;
+  BoundedQueue &operator=(const BoundedQueue &other) = delete;
+  ~BoundedQueue() = default;
+
+  /// @brief enqueues value, waits while the queue is full
+  /// @return false if the queue is closed (value is dropped)
+  bool Push(T value) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    not_full_.wait(lock,
+                   [this]() { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(value));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// @brief enqueues value if there is room, does not wait
+  /// @return false if the queue is full or closed (value is not moved)
+  bool TryPush(T &value) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (closed_ || items_.size() >= capacity_) {
+      return false;
+    }
+    items_.push_back(std::move(value));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// @brief dequeues value, waits while the queue is empty
+  /// @return false if the queue is closed and empty
+  bool Pop(T &value) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    value = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// @brief dequeues value if there is one, does not wait
+  /// @return false if the queue is empty
+  bool TryPop(T &value) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (items_.empty()) {
+      return false;
+    }
+    value = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// @brief wakes up all waiting threads, further Push calls fail
+  void Close() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+private:
+  std::size_t capacity_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  std::mutex mtx_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_BOUNDED_QUEUE_H_
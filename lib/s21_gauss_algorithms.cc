@@ -2,18 +2,61 @@
 
 #include <algorithm>
 #include <cmath>
-#include <future>
-#include <mutex>
-#include <thread>
+#include <stdexcept>
+#include <tuple>
+
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
 
 namespace s21 {
 
-SimpleGauss::SimpleGauss(m_ptr m, row_ptr r)
-    : Gauss(), matrix_(m), output_(r), rows_(matrix_->size()),
-      cols_(matrix_->at(0).size()) {}
+namespace {
+
+/// @brief pivots below are treated as zero (as in SimpleGauss::CheckEchelon)
+constexpr double kPivotEps = 0.00001;
+
+/// @brief fewest rows per member of the ParallelGauss team: every step ends
+/// with two barriers, which cost more than updating fewer rows
+constexpr std::size_t kMinTeamRows = 32;
+
+/// @brief columns of the trailing matrix updated at once, the block row of
+/// U over them stays in L2
+constexpr std::size_t kUpdateCols = 256;
+
+} // namespace
+
+m_dbl_type &GaussWorkspace::GetMatrix(std::size_t rows, std::size_t cols) {
+  if (matrix_.rows() != rows || matrix_.cols() != cols) {
+    matrix_ = m_dbl_type(rows, cols);
+  }
+  return matrix_;
+}
+
+row_type &GaussWorkspace::GetVector(std::size_t size) {
+  if (vector_.size() < size) {
+    vector_.resize(size);
+  }
+  return vector_;
+}
+
+std::vector<std::size_t> &GaussWorkspace::GetIndices(std::size_t size) {
+  if (indices_.size() < size) {
+    indices_.resize(size);
+  }
+  return indices_;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+SimpleGauss::SimpleGauss(const_m_ptr m, row_ptr r, workspace_ptr workspace)
+    : Gauss(), matrix_(m), output_(r), rows_(matrix_->rows()),
+      cols_(matrix_->cols()),
+      workspace_(workspace ? workspace : std::make_shared<GaussWorkspace>()),
+      work_(workspace_->GetMatrix(rows_, cols_)) {}
 
 void SimpleGauss::SolveSle() {
-  m_dbl_type buff_matrix = *matrix_;
+  LoadWork();
 
   LeadToEchelon();
 
@@ -24,85 +67,530 @@ void SimpleGauss::SolveSle() {
   CheckEchelon();
 
   BackPropagation();
-  *matrix_ = buff_matrix;
+}
+
+void SimpleGauss::LoadWork() {
+  S21_TRACE_SCOPE("LoadWork");
+  // the shape is the same as in the ctor, GetMatrix does not reallocate
+  workspace_->GetMatrix(rows_, cols_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    std::copy((*matrix_)[i], (*matrix_)[i] + cols_, work_[i]);
+  }
 }
 
 void SimpleGauss::AdjustEchelon(std::size_t k) {
-  for (size_t i = k + 1; i < rows_; ++i) {
-    double f = matrix_->at(i).at(k) / matrix_->at(k).at(k);
+  S21_TRACE_SCOPE("AdjustEchelon");
+  AdjustRows(k, k + 1, rows_);
+}
+
+void SimpleGauss::AdjustRows(std::size_t k, std::size_t start,
+                             std::size_t end) {
+  S21_TRACE_SCOPE("AdjustRows");
+  const double *pivot = work_[k];
+  for (size_t i = start; i < end; ++i) {
+    double *row = work_[i];
+    double f = row[k] / pivot[k];
 
     for (size_t j = k + 1; j <= rows_; ++j)
-      matrix_->at(i).at(j) -= matrix_->at(k).at(j) * f;
-    matrix_->at(i).at(k) = 0;
+      row[j] -= pivot[j] * f;
+    row[k] = 0;
   }
 }
 
 void SimpleGauss::LeadToEchelon() {
+  S21_TRACE_SCOPE("LeadToEchelon");
   for (std::size_t k = 0; k < rows_; ++k) {
     std::size_t max_index = k;
     double max_value = 0;
     for (std::size_t i = k; i < rows_; ++i) {
+      const double *row = work_[i];
       double scale_factor = 0;
       for (std::size_t j = k; j < rows_; ++j)
-        scale_factor = std::max(std::abs(matrix_->at(i).at(j)), scale_factor);
+        scale_factor = std::max(std::abs(row[j]), scale_factor);
       if (scale_factor == 0)
         continue;
-      auto abs = std::abs(matrix_->at(i).at(k)) / scale_factor;
+      auto abs = std::abs(row[k]) / scale_factor;
       if (abs > max_value) {
         max_index = i;
         max_value = abs;
       }
     }
     if (k != max_index)
-      std::swap(matrix_->at(k), matrix_->at(max_index));
+      work_.SwapRows(k, max_index);
   }
 }
 
 void SimpleGauss::CheckEchelon() {
+  S21_TRACE_SCOPE("CheckEchelon");
   for (std::size_t k = 0; k < rows_; ++k) {
-    if (fabs(matrix_->at(k).at(k)) < 0.00001)
+    if (fabs(work_(k, k)) < 0.00001)
       throw std::runtime_error("matrix is singular");
   }
 }
 
 void SimpleGauss::BackPropagation() {
+  S21_TRACE_SCOPE("BackPropagation");
   for (size_t i = rows_; i-- > 0;) {
-    output_->at(i) = matrix_->at(i).at(rows_);
+    const double *row = work_[i];
+    row_type &output = *output_;
+    output[i] = row[rows_];
     for (size_t j = i + 1; j < rows_; ++j)
-      output_->at(i) -= matrix_->at(i).at(j) * output_->at(j);
-    output_->at(i) /= matrix_->at(i).at(i);
+      output[i] -= row[j] * output[j];
+    output[i] /= row[i];
   }
 }
 
 void ParallelGauss::SolveSle() {
-  m_dbl_type buff_matrix = *matrix_;
+  LoadWork();
 
-  LeadToEchelon();
+  Eliminate();
 
-  std::vector<std::future<void>> futures;
-  for (std::size_t k = 0; k < rows_; ++k) {
-    futures.push_back(
-        std::async(std::launch::async, &ParallelGauss::AdjustEchelon, this, k));
+  BackPropagation();
+}
+
+void ParallelGauss::Eliminate() {
+  const std::size_t team =
+      std::max<std::size_t>(std::min(th_count_, rows_ / kMinTeamRows), 1);
+  // members are pinned like the pool workers (S21_AFFINITY, --affinity)
+  const std::vector<int> &cpus = ThreadPool::Instance().Cpus();
+  if (!team_ || team_->Size() != team || team_->Cpus() != cpus) {
+    team_ = std::make_unique<ThreadTeam>(team, cpus);
+    pivots_.resize(team);
+  }
+  Barrier barrier(team);
+  std::vector<Pivot> &pivots = pivots_;
+  bool singular = false;
+
+  team_->Run([&](std::size_t id) {
+    auto [start, end] = Chunk(0, rows_, id, team);
+    pivots[id] = FindPivot(0, start, end);
+    for (std::size_t k = 0; k < rows_; ++k) {
+      barrier.ArriveAndWait();
+      if (id == 0) {
+        Pivot pivot = pivots[0];
+        for (std::size_t t = 1; t < team; ++t) {
+          if (pivots[t].value > pivot.value) {
+            pivot = pivots[t];
+          }
+        }
+        singular = pivot.value < kPivotEps;
+        if (!singular) {
+          work_.SwapRows(k, pivot.index);
+        }
+      }
+      barrier.ArriveAndWait();
+      if (singular) {
+        return;
+      }
+      // rows updated by a thread are the rows it searches for the next pivot
+      std::tie(start, end) = Chunk(k + 1, rows_, id, team);
+      AdjustRows(k, start, end);
+      pivots[id] = FindPivot(k + 1, start, end);
+    }
+  });
+  if (singular) {
+    throw std::runtime_error("matrix is singular");
+  }
+}
+
+std::pair<std::size_t, std::size_t>
+ParallelGauss::Chunk(std::size_t start, std::size_t end, std::size_t id,
+                     std::size_t team) {
+  const std::size_t size = end > start ? end - start : 0;
+  return {start + size * id / team, start + size * (id + 1) / team};
+}
+
+ParallelGauss::Pivot ParallelGauss::FindPivot(std::size_t k,
+                                              std::size_t start,
+                                              std::size_t end) const {
+  S21_TRACE_SCOPE("FindPivot");
+  Pivot pivot = {-1.0, start};
+  if (k >= rows_) {
+    return pivot;
+  }
+  for (std::size_t i = start; i < end; ++i) {
+    double value = std::abs(work_(i, k));
+    if (value > pivot.value) {
+      pivot = {value, i};
+    }
+  }
+  return pivot;
+}
+
+BlockedGauss::BlockedGauss(const_m_ptr m, row_ptr r, std::size_t th_count,
+                           std::size_t block, workspace_ptr workspace)
+    : Gauss(), matrix_(m), output_(r), rows_(matrix_->rows()),
+      th_count_(std::max<std::size_t>(th_count, 1)),
+      block_(block ? block : kDefaultBlock),
+      workspace_(workspace ? workspace : std::make_shared<GaussWorkspace>()),
+      lu_(workspace_->GetMatrix(rows_, matrix_->cols())),
+      perm_(workspace_->GetIndices(rows_)) {}
+
+void BlockedGauss::SolveSle() {
+  Factor();
+  row_type &b = workspace_->GetVector(rows_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    b[i] = (*matrix_)(i, rows_);
+  }
+  Solve(b.data(), output_->data());
+}
+
+void BlockedGauss::Factor() {
+  S21_TRACE_SCOPE("FactorLu");
+  factored_ = false;
+  // the same shape as in the ctor, the workspace does not reallocate
+  workspace_->GetMatrix(rows_, matrix_->cols());
+  workspace_->GetIndices(rows_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    std::copy((*matrix_)[i], (*matrix_)[i] + rows_, lu_[i]);
   }
-  for (auto &f : futures) {
-    f.wait();
+  for (std::size_t i = 0; i < rows_; ++i) {
+    perm_[i] = i;
   }
 
-  std::thread th_1(&ParallelGauss::CheckEchelon, this);
-  th_1.join();
+  for (std::size_t k = 0; k < rows_; k += block_) {
+    const std::size_t width = std::min(block_, rows_ - k);
+    FactorPanel(k, width);
+    if (k + width < rows_) {
+      SolveBlockRow(k, width);
+      UpdateTrailing(k, width);
+    }
+  }
+  factored_ = true;
+}
 
-  std::thread th_2(&ParallelGauss::BackPropagation, this);
-  th_2.join();
+void BlockedGauss::FactorPanel(std::size_t k, std::size_t width) {
+  S21_TRACE_SCOPE("FactorPanel");
+  for (std::size_t j = k; j < k + width; ++j) {
+    std::size_t max_index = j;
+    double max_value = std::abs(lu_(perm_[j], j));
+    for (std::size_t i = j + 1; i < rows_; ++i) {
+      double value = std::abs(lu_(perm_[i], j));
+      if (value > max_value) {
+        max_index = i;
+        max_value = value;
+      }
+    }
+    if (max_value < kPivotEps) {
+      throw std::runtime_error("matrix is singular");
+    }
+    std::swap(perm_[j], perm_[max_index]);
 
-  *matrix_ = buff_matrix;
+    // L column and the update of the rest of the panel
+    const double *pivot = lu_[perm_[j]];
+    for (std::size_t i = j + 1; i < rows_; ++i) {
+      double *row = lu_[perm_[i]];
+      const double l = row[j] /= pivot[j];
+      for (std::size_t c = j + 1; c < k + width; ++c) {
+        row[c] -= l * pivot[c];
+      }
+    }
+  }
 }
 
-void ParallelGauss::AdjustEchelon(std::size_t k) {
-  SimpleGauss::AdjustEchelon(k);
+void BlockedGauss::SolveBlockRow(std::size_t k, std::size_t width) {
+  S21_TRACE_SCOPE("SolveBlockRow");
+  // U12 = L11^-1 A12, row by row
+  for (std::size_t j = k + 1; j < k + width; ++j) {
+    double *row = lu_[perm_[j]];
+    for (std::size_t t = k; t < j; ++t) {
+      const double l = row[t];
+      const double *upper = lu_[perm_[t]];
+      for (std::size_t c = k + width; c < rows_; ++c) {
+        row[c] -= l * upper[c];
+      }
+    }
+  }
 }
 
-void ParallelGauss::CheckEchelon() { SimpleGauss::CheckEchelon(); }
+void BlockedGauss::UpdateTrailing(std::size_t k, std::size_t width) {
+  // A22 -= L21 U12
+  ParallelFor(k + width, rows_, th_count_,
+              [this, k, width](std::size_t start, std::size_t end) {
+                S21_TRACE_SCOPE("UpdateTrailing");
+                for (std::size_t col = k + width; col < rows_;
+                     col += kUpdateCols) {
+                  const std::size_t last = std::min(col + kUpdateCols, rows_);
+                  for (std::size_t i = start; i < end; ++i) {
+                    UpdateRow(lu_[perm_[i]], k, width, col, last);
+                  }
+                }
+              });
+}
 
-void ParallelGauss::BackPropagation() { SimpleGauss::BackPropagation(); }
+void BlockedGauss::UpdateRow(double *row, std::size_t k, std::size_t width,
+                             std::size_t col, std::size_t last) const {
+  // four rows of U per pass, the row is loaded and stored once per pass
+  std::size_t t = k;
+  for (; t + 4 <= k + width; t += 4) {
+    const double l0 = row[t], l1 = row[t + 1], l2 = row[t + 2],
+                 l3 = row[t + 3];
+    const double *u0 = lu_[perm_[t]];
+    const double *u1 = lu_[perm_[t + 1]];
+    const double *u2 = lu_[perm_[t + 2]];
+    const double *u3 = lu_[perm_[t + 3]];
+    for (std::size_t c = col; c < last; ++c) {
+      row[c] -= l0 * u0[c] + l1 * u1[c] + l2 * u2[c] + l3 * u3[c];
+    }
+  }
+  for (; t < k + width; ++t) {
+    const double l = row[t];
+    const double *upper = lu_[perm_[t]];
+    for (std::size_t c = col; c < last; ++c) {
+      row[c] -= l * upper[c];
+    }
+  }
+}
+
+void BlockedGauss::Solve(const double *b, double *x) const {
+  S21_TRACE_SCOPE("Substitute");
+  // L y = P b, y is kept in x
+  for (std::size_t i = 0; i < rows_; ++i) {
+    const double *row = lu_[perm_[i]];
+    double value = b[perm_[i]];
+    for (std::size_t t = 0; t < i; ++t) {
+      value -= row[t] * x[t];
+    }
+    x[i] = value;
+  }
+  // U x = y
+  for (std::size_t i = rows_; i-- > 0;) {
+    const double *row = lu_[perm_[i]];
+    double value = x[i];
+    for (std::size_t t = i + 1; t < rows_; ++t) {
+      value -= row[t] * x[t];
+    }
+    x[i] = value / row[i];
+  }
+}
+
+void BlockedGauss::Solve(const m_dbl_type &b, m_dbl_type &x) const {
+  if (b.rows() != rows_ || x.rows() != rows_ || x.cols() != b.cols()) {
+    throw "";
+  }
+  // rows of X are updated as a whole, so every step is a vector operation
+  // over the band of columns
+  ParallelFor(0, b.cols(), th_count_,
+              [this, &b, &x](std::size_t start, std::size_t end) {
+                S21_TRACE_SCOPE("Substitute");
+                for (std::size_t i = 0; i < rows_; ++i) {
+                  const double *row = lu_[perm_[i]];
+                  double *result = x[i];
+                  std::copy(b[perm_[i]] + start, b[perm_[i]] + end,
+                            result + start);
+                  for (std::size_t t = 0; t < i; ++t) {
+                    const double l = row[t];
+                    const double *solved = x[t];
+                    for (std::size_t c = start; c < end; ++c) {
+                      result[c] -= l * solved[c];
+                    }
+                  }
+                }
+                for (std::size_t i = rows_; i-- > 0;) {
+                  const double *row = lu_[perm_[i]];
+                  double *result = x[i];
+                  for (std::size_t t = i + 1; t < rows_; ++t) {
+                    const double u = row[t];
+                    const double *solved = x[t];
+                    for (std::size_t c = start; c < end; ++c) {
+                      result[c] -= u * solved[c];
+                    }
+                  }
+                  for (std::size_t c = start; c < end; ++c) {
+                    result[c] /= row[i];
+                  }
+                }
+              });
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+TiledGauss::TiledGauss(const_m_ptr m, row_ptr r, std::size_t th_count,
+                       std::size_t tile, workspace_ptr workspace)
+    : Gauss(), matrix_(m), output_(r), rows_(matrix_->rows()),
+      th_count_(std::max<std::size_t>(th_count, 1)),
+      tile_(tile ? tile : kDefaultTile),
+      tiles_((rows_ + tile_ - 1) / tile_),
+      workspace_(workspace ? workspace : std::make_shared<GaussWorkspace>()),
+      work_(workspace_->GetMatrix(rows_, matrix_->cols())),
+      pivots_(workspace_->GetIndices(rows_)) {
+  BuildGraph();
+}
+
+void TiledGauss::SolveSle() {
+  S21_TRACE_SCOPE("FactorTiles");
+  // the same shape as in the ctor, the workspace does not reallocate
+  workspace_->GetMatrix(rows_, matrix_->cols());
+  workspace_->GetIndices(rows_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    std::copy((*matrix_)[i], (*matrix_)[i] + rows_ + 1, work_[i]);
+  }
+  graph_.Run(th_count_);
+  BackPropagation();
+}
+
+std::size_t TiledGauss::ColumnBegin(std::size_t j) const {
+  return j < tiles_ ? j * tile_ : rows_;
+}
+
+std::size_t TiledGauss::ColumnEnd(std::size_t j) const {
+  return j < tiles_ ? std::min((j + 1) * tile_, rows_) : rows_ + 1;
+}
+
+void TiledGauss::BuildGraph() {
+  // last task writing tile (i, j); the right-hand side is column tiles_
+  constexpr TaskGraph::TaskId kNone = ~TaskGraph::TaskId(0);
+  const std::size_t cols = tiles_ + 1;
+  std::vector<TaskGraph::TaskId> last(tiles_ * cols, kNone);
+  auto column_writers = [&](std::size_t k, std::size_t j) {
+    std::vector<TaskGraph::TaskId> writers;
+    for (std::size_t i = k; i < tiles_; ++i) {
+      if (last[i * cols + j] != kNone) {
+        writers.push_back(last[i * cols + j]);
+      }
+    }
+    return writers;
+  };
+  auto add_panel = [&](std::size_t k) {
+    auto panel = graph_.Add([this, k]() { FactorPanel(k); },
+                            column_writers(k, k));
+    for (std::size_t i = k; i < tiles_; ++i) {
+      last[i * cols + k] = panel;
+    }
+    return panel;
+  };
+
+  std::vector<TaskGraph::TaskId> panels(tiles_);
+  if (tiles_ > 0) {
+    panels[0] = add_panel(0);
+  }
+  for (std::size_t k = 0; k < tiles_; ++k) {
+    for (std::size_t j = k + 1; j <= tiles_; ++j) {
+      // row exchanges touch every tile of the column below the panel
+      auto dependencies = column_writers(k, j);
+      dependencies.push_back(panels[k]);
+      auto row = graph_.Add([this, k, j]() { SolveTileRow(k, j); },
+                            dependencies);
+      for (std::size_t i = k; i < tiles_; ++i) {
+        last[i * cols + j] = row;
+      }
+      for (std::size_t i = k + 1; i < tiles_; ++i) {
+        last[i * cols + j] =
+            graph_.Add([this, k, i, j]() { UpdateTile(k, i, j); }, {row});
+      }
+      // the next panel is added as soon as its column is updated, so that
+      // it goes ahead of the rest of the step (lower ids run first)
+      if (j == k + 1 && j < tiles_) {
+        panels[j] = add_panel(j);
+      }
+    }
+  }
+}
+
+void TiledGauss::FactorPanel(std::size_t k) {
+  S21_TRACE_SCOPE("FactorPanel");
+  const std::size_t first = ColumnBegin(k);
+  const std::size_t last = ColumnEnd(k);
+  for (std::size_t c = first; c < last; ++c) {
+    std::size_t max_index = c;
+    double max_value = std::abs(work_(c, c));
+    for (std::size_t i = c + 1; i < rows_; ++i) {
+      double value = std::abs(work_(i, c));
+      if (value > max_value) {
+        max_index = i;
+        max_value = value;
+      }
+    }
+    if (max_value < kPivotEps) {
+      throw std::runtime_error("matrix is singular");
+    }
+    pivots_[c] = max_index;
+    if (max_index != c) {
+      std::swap_ranges(work_[c] + first, work_[c] + last,
+                       work_[max_index] + first);
+    }
+
+    const double *pivot = work_[c];
+    for (std::size_t i = c + 1; i < rows_; ++i) {
+      double *row = work_[i];
+      const double l = row[c] /= pivot[c];
+      for (std::size_t t = c + 1; t < last; ++t) {
+        row[t] -= l * pivot[t];
+      }
+    }
+  }
+}
+
+void TiledGauss::SolveTileRow(std::size_t k, std::size_t j) {
+  S21_TRACE_SCOPE("SolveTileRow");
+  const std::size_t first = ColumnBegin(k);
+  const std::size_t last = ColumnEnd(k);
+  const std::size_t begin = ColumnBegin(j);
+  const std::size_t end = ColumnEnd(j);
+  for (std::size_t c = first; c < last; ++c) {
+    if (pivots_[c] != c) {
+      std::swap_ranges(work_[c] + begin, work_[c] + end,
+                       work_[pivots_[c]] + begin);
+    }
+  }
+  // U(k, j) = L(k, k)^-1 A(k, j)
+  for (std::size_t r = first + 1; r < last; ++r) {
+    double *row = work_[r];
+    for (std::size_t t = first; t < r; ++t) {
+      const double l = row[t];
+      const double *upper = work_[t];
+      for (std::size_t c = begin; c < end; ++c) {
+        row[c] -= l * upper[c];
+      }
+    }
+  }
+}
+
+void TiledGauss::UpdateTile(std::size_t k, std::size_t i, std::size_t j) {
+  S21_TRACE_SCOPE("UpdateTile");
+  const std::size_t first = ColumnBegin(k);
+  const std::size_t last = ColumnEnd(k);
+  const std::size_t begin = ColumnBegin(j);
+  const std::size_t end = ColumnEnd(j);
+  // A(i, j) -= L(i, k) U(k, j), four rows of U per pass over the row
+  for (std::size_t r = i * tile_; r < std::min((i + 1) * tile_, rows_); ++r) {
+    double *row = work_[r];
+    std::size_t t = first;
+    for (; t + 4 <= last; t += 4) {
+      const double l0 = row[t];
+      const double l1 = row[t + 1];
+      const double l2 = row[t + 2];
+      const double l3 = row[t + 3];
+      const double *u0 = work_[t];
+      const double *u1 = work_[t + 1];
+      const double *u2 = work_[t + 2];
+      const double *u3 = work_[t + 3];
+      for (std::size_t c = begin; c < end; ++c) {
+        row[c] -= l0 * u0[c] + l1 * u1[c] + l2 * u2[c] + l3 * u3[c];
+      }
+    }
+    for (; t < last; ++t) {
+      const double l = row[t];
+      const double *upper = work_[t];
+      for (std::size_t c = begin; c < end; ++c) {
+        row[c] -= l * upper[c];
+      }
+    }
+  }
+}
+
+void TiledGauss::BackPropagation() {
+  S21_TRACE_SCOPE("BackPropagation");
+  row_type &x = *output_;
+  for (std::size_t i = rows_; i-- > 0;) {
+    const double *row = work_[i];
+    double value = row[rows_];
+    for (std::size_t t = i + 1; t < rows_; ++t) {
+      value -= row[t] * x[t];
+    }
+    x[i] = value / row[i];
+  }
+}
 
 } // namespace s21
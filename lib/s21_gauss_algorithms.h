@@ -4,12 +4,36 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
+#include "s21_thread_pool.h"
 #include "s21_types.h"
 
 namespace s21 {
 
+/// @brief reusable buffers of Gauss engines (arena). A buffer is reallocated
+/// only when a bigger or differently shaped one is requested, so repeated
+/// solves of the same size allocate no buffers. The storage owns one workspace
+/// and passes it to every engine it creates; engines sharing a workspace
+/// must not solve at the same time.
+class GaussWorkspace {
+public:
+  /// @brief working copy of the SLE
+  m_dbl_type &GetMatrix(std::size_t rows, std::size_t cols);
+  /// @brief vector of at least "size" values
+  row_type &GetVector(std::size_t size);
+  /// @brief vector of at least "size" indices
+  std::vector<std::size_t> &GetIndices(std::size_t size);
+
+private:
+  m_dbl_type matrix_;
+  row_type vector_;
+  std::vector<std::size_t> indices_;
+};
+
+using workspace_ptr = std::shared_ptr<GaussWorkspace>;
+
 /// @brief class for solving of SLEs with using of Gauss method. Used only
 /// in conjunction with storage class.
 class Gauss {
@@ -27,40 +51,205 @@ class SimpleGauss : public Gauss {
 
 public:
   /// @brief ctor. Initialize matrix and output vector using smart pointers
-  /// @param m input matrix - system of linear equations
+  /// @param m input matrix - system of linear equations. It is not changed,
+  /// the elimination runs in a copy made in the workspace
   /// @param r output vector. Has the size "answer + 1"
-  SimpleGauss(m_ptr m, row_ptr r);
+  /// @param workspace buffers shared with other engines, null - own ones
+  SimpleGauss(const_m_ptr m, row_ptr r, workspace_ptr workspace = nullptr);
 
   /// @brief solves SLE in linear mode
   void SolveSle() override;
 
 protected:
-  m_ptr matrix_;
+  const_m_ptr matrix_;
   row_ptr output_;
   std::size_t rows_;
   std::size_t cols_;
+  workspace_ptr workspace_;
+  /// @brief working copy of the SLE in the workspace
+  m_dbl_type &work_;
+
+  /// @brief copies the SLE into the working copy
+  void LoadWork();
 
   void AdjustEchelon(std::size_t k);
+  void AdjustRows(std::size_t k, std::size_t start, std::size_t end);
   void LeadToEchelon();
   void CheckEchelon();
   void BackPropagation();
 };
 
-/// @brief solves SLEs in parallel mode
+/// @brief solves SLEs in parallel mode. A team of up to th_count threads
+/// (at least 32 rows each; started by the first solve, kept by the engine
+/// and pinned like the pool workers) runs the whole elimination: for every
+/// pivot the threads search their rows for the largest element of the
+/// column (partial pivoting), the first thread swaps the pivot row into
+/// place, then the threads update their rows of the trailing matrix. Steps
+/// are separated by barriers, so step k reads only rows completed by step
+/// k - 1.
 class ParallelGauss : public SimpleGauss {
 public:
-  ParallelGauss(m_ptr m, row_ptr r, std::size_t th_count = 1)
-      : SimpleGauss(m, r), th_count_(th_count){};
+  ParallelGauss(const_m_ptr m, row_ptr r, std::size_t th_count = 1,
+                workspace_ptr workspace = nullptr)
+      : SimpleGauss(m, r, workspace), th_count_(th_count){};
   ~ParallelGauss() = default;
 
   /// @brief solves SLEs in parallel mode
+  /// @throw std::runtime_error if the matrix is singular
   void SolveSle() override;
 
 private:
+  /// @brief largest element of a column among rows of a thread
+  struct Pivot {
+    double value;
+    std::size_t index;
+  };
+
   std::size_t th_count_;
+  /// @brief candidates of the threads, kept between solves
+  std::vector<Pivot> pivots_;
+  std::unique_ptr<ThreadTeam> team_;
 
-  void AdjustEchelon(std::size_t k);
-  void CheckEchelon();
+  void Eliminate();
+  /// @brief part of rows [start, end) of thread "id" of "team"
+  static std::pair<std::size_t, std::size_t>
+  Chunk(std::size_t start, std::size_t end, std::size_t id, std::size_t team);
+  Pivot FindPivot(std::size_t k, std::size_t start, std::size_t end) const;
+};
+
+/// @brief solves SLEs by right-looking blocked LU factorization with partial
+/// pivoting. Every step factors a panel of "block" columns (pivots are
+/// searched in the column, rows are exchanged in the permutation vector, not
+/// in memory), solves the block row of U and updates the trailing matrix by
+/// a matrix-multiply-shaped loop spread between threads of the pool. The
+/// factorization is made in the workspace, the input matrix is not changed.
+class BlockedGauss : public Gauss {
+public:
+  /// @brief default number of columns of a panel
+  static constexpr std::size_t kDefaultBlock = 64;
+
+  /// @brief ctor
+  /// @param m input matrix - system of linear equations
+  /// @param r output vector. Has the size "answer + 1"
+  /// @param th_count number of threads of the trailing update
+  /// @param block columns of a panel, 0 - kDefaultBlock
+  /// @param workspace buffers shared with other engines, null - own ones.
+  /// The factors are valid until another engine uses the workspace
+  BlockedGauss(const_m_ptr m, row_ptr r, std::size_t th_count = 1,
+               std::size_t block = 0, workspace_ptr workspace = nullptr);
+  ~BlockedGauss() = default;
+
+  /// @brief factors the matrix and solves the SLE
+  /// @throw std::runtime_error if the matrix is singular
+  void SolveSle() override;
+
+  /// @brief factors coefficients of the matrix (all columns but the last)
+  /// into L, U and the permutation, which are kept for Solve
+  /// @throw std::runtime_error if the matrix is singular
+  void Factor();
+  /// @brief true if Factor succeeded
+  bool IsFactored() const { return factored_; }
+
+  /// @brief solves A x = b by forward and back substitution with the kept
+  /// factors, O(n^2)
+  /// @param b right-hand side, rows values
+  /// @param x solution, rows values
+  void Solve(const double *b, double *x) const;
+  /// @brief solves A X = B for all columns of B at once; bands of columns
+  /// are substituted by threads of the pool
+  /// @param b right-hand sides, rows x k
+  /// @param x solutions, rows x k
+  void Solve(const m_dbl_type &b, m_dbl_type &x) const;
+
+  std::size_t GetBlock() const { return block_; }
+  void SetThreadCount(std::size_t th_count) {
+    th_count_ = std::max<std::size_t>(th_count, 1);
+  }
+
+protected:
+  const_m_ptr matrix_;
+  row_ptr output_;
+  std::size_t rows_;
+  std::size_t th_count_;
+  std::size_t block_;
+  workspace_ptr workspace_;
+  /// @brief L (unit diagonal, below) and U (on and above the diagonal)
+  /// factors in the working copy of the SLE; logical row i is physical row
+  /// perm_[i]
+  m_dbl_type &lu_;
+  std::vector<std::size_t> &perm_;
+  bool factored_ = false;
+
+private:
+  void FactorPanel(std::size_t k, std::size_t width);
+  void SolveBlockRow(std::size_t k, std::size_t width);
+  void UpdateTrailing(std::size_t k, std::size_t width);
+  /// @brief row[col, last) -= row[k, k + width) * U[k, k + width)[col, last)
+  void UpdateRow(double *row, std::size_t k, std::size_t width,
+                 std::size_t col, std::size_t last) const;
+};
+
+/// @brief tiled LU factorization with partial pivoting scheduled as a task
+/// graph (Gauss mode kTiled). The SLE is split into tiles of tile x tile
+/// elements, the right-hand side is a column of tiles of its own. Every
+/// step k is made of tasks: the panel (column of tiles k, pivot search and
+/// L), the row exchange and triangular solve of every tile (k, j) and the
+/// update of every tile (i, j) below. A task starts as soon as the tiles it
+/// reads are written, so the next panel is factored while the updates of
+/// the previous step still run. Row exchanges are applied to the columns
+/// right of the panel only, the right-hand side is eliminated together
+/// with U and the solution is found by back substitution.
+class TiledGauss : public Gauss {
+public:
+  /// @brief default size of a tile
+  static constexpr std::size_t kDefaultTile = 64;
+
+  /// @brief ctor. Builds the task graph for the size of the SLE
+  /// @param m input matrix - system of linear equations
+  /// @param r output vector. Has the size "answer + 1"
+  /// @param th_count number of threads running the tasks
+  /// @param tile rows and columns of a tile, 0 - kDefaultTile
+  /// @param workspace buffers shared with other engines, null - own ones
+  TiledGauss(const_m_ptr m, row_ptr r, std::size_t th_count = 1,
+             std::size_t tile = 0, workspace_ptr workspace = nullptr);
+  TiledGauss(const TiledGauss &other) = delete;
+  TiledGauss &operator=(const TiledGauss &other) = delete;
+  ~TiledGauss() = default;
+
+  /// @brief factors the matrix and solves the SLE
+  /// @throw std::runtime_error if the matrix is singular
+  void SolveSle() override;
+
+  std::size_t GetTile() const { return tile_; }
+  /// @brief number of tasks of the graph
+  std::size_t GetTaskCount() const { return graph_.Size(); }
+  void SetThreadCount(std::size_t th_count) {
+    th_count_ = std::max<std::size_t>(th_count, 1);
+  }
+
+private:
+  const_m_ptr matrix_;
+  row_ptr output_;
+  std::size_t rows_;
+  std::size_t th_count_;
+  std::size_t tile_;
+  /// @brief number of tiles on the diagonal
+  std::size_t tiles_;
+  workspace_ptr workspace_;
+  /// @brief working copy of the SLE, factored in place
+  m_dbl_type &work_;
+  /// @brief row exchanged with row c by the panel of column c
+  std::vector<std::size_t> &pivots_;
+  TaskGraph graph_;
+
+  void BuildGraph();
+  /// @brief first column of the column of tiles j, j == tiles_ - the
+  /// right-hand side
+  std::size_t ColumnBegin(std::size_t j) const;
+  std::size_t ColumnEnd(std::size_t j) const;
+  void FactorPanel(std::size_t k);
+  void SolveTileRow(std::size_t k, std::size_t j);
+  void UpdateTile(std::size_t k, std::size_t i, std::size_t j);
   void BackPropagation();
 };
 
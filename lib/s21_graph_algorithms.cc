@@ -6,12 +6,15 @@
 #include <future>
 #include <memory>
 #include <random>
-#include <thread>
 #include <vector>
 
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
+
 namespace s21 {
 
-LinearSolver::LinearSolver(m_ptr matrix, std::shared_ptr<TsmResult> result)
+LinearSolver::LinearSolver(const_m_ptr matrix,
+                           std::shared_ptr<TsmResult> result)
     : matrix_(matrix), best_result_(result) {
   phero_ptr_ =
       std::make_shared<m_dbl_type>(InitializePheromone(matrix_->size()));
@@ -21,11 +24,11 @@ m_dbl_type LinearSolver::InitializePheromone(int n) const {
   if (n < 1) {
     throw "";
   }
-  return m_dbl_type(n, std::vector<double>(n, kInitialPheromone));
+  return m_dbl_type(n, n, kInitialPheromone);
 }
 
 double LinearSolver::Eta(int i, int j) const {
-  return 1.0 / (matrix_->at(i).at(j));
+  return 1.0 / (*matrix_)(i, j);
 }
 
 int LinearSolver::Random() const {
@@ -43,15 +46,15 @@ int LinearSolver::SelectNext(const int cur,
   int size = visited.size();
   double sum = 0.0;
   for (int i = 0; i < size; ++i) {
-    if (visited.at(i) == false && (matrix_->at(cur).at(i) > 0)) {
-      sum += pow(phero_ptr_->at(cur).at(i), kAlpha) * pow(Eta(cur, i), kBeta);
+    if (visited.at(i) == false && ((*matrix_)(cur, i) > 0)) {
+      sum += pow((*phero_ptr_)(cur, i), kAlpha) * pow(Eta(cur, i), kBeta);
     }
   }
 
   for (int i = 0; i < size; ++i) {
-    if (visited.at(i) == false && (matrix_->at(cur).at(i) > 0)) {
+    if (visited.at(i) == false && ((*matrix_)(cur, i) > 0)) {
       double buff_attractivness = 0.0;
-      buff_attractivness = pow(phero_ptr_->at(cur).at(i), kAlpha) *
+      buff_attractivness = pow((*phero_ptr_)(cur, i), kAlpha) *
                            pow(Eta(cur, i), kBeta) / sum;
       if (buff_attractivness > answ_attractivness) {
         answ = i;
@@ -63,8 +66,10 @@ int LinearSolver::SelectNext(const int cur,
 }
 
 void LinearSolver::UpdatePheromone(const std::vector<Ant> &ants) {
-  for (auto &start : *phero_ptr_) {
-    std::transform(start.cbegin(), start.cend(), start.begin(),
+  S21_TRACE_SCOPE("UpdatePheromone");
+  for (std::size_t i = 0; i < phero_ptr_->rows(); ++i) {
+    double *row = (*phero_ptr_)[i];
+    std::transform(row, row + phero_ptr_->cols(), row,
                    [this](double x) { return x * kRHO; });
   }
 
@@ -73,13 +78,14 @@ void LinearSolver::UpdatePheromone(const std::vector<Ant> &ants) {
          itr != ant.ant_result_.vertices_.end() - 1; ++itr) {
       int start = *itr;
       int end = *(itr + 1);
-      phero_ptr_->at(start).at(end) +=
-          ant.quantity_ / matrix_->at(start).at(end);
+      (*phero_ptr_)(start, end) +=
+          ant.quantity_ / (*matrix_)(start, end);
     }
   }
 }
 
 Ant LinearSolver::BuildTour(int start, std::vector<bool> &visited) const {
+  S21_TRACE_SCOPE("BuildTour");
   Ant ant;
   ant.ant_result_.vertices_.push_back(start);
   ant.ant_result_.distance_ = 0.0;
@@ -93,16 +99,16 @@ Ant LinearSolver::BuildTour(int start, std::vector<bool> &visited) const {
       break;
     }
     ant.ant_result_.vertices_.push_back(next);
-    ant.ant_result_.distance_ += matrix_->at(current).at(next);
-    ant.quantity_ += phero_ptr_->at(current).at(next);
+    ant.ant_result_.distance_ += (*matrix_)(current, next);
+    ant.quantity_ += (*phero_ptr_)(current, next);
     visited.at(next) = true;
     current = next;
   }
 
-  if (matrix_->at(current).at(start) > 0) {
+  if ((*matrix_)(current, start) > 0) {
     ant.ant_result_.vertices_.push_back(start);
-    ant.ant_result_.distance_ += matrix_->at(current).at(start);
-    ant.quantity_ += phero_ptr_->at(current).at(start);
+    ant.ant_result_.distance_ += (*matrix_)(current, start);
+    ant.quantity_ += (*phero_ptr_)(current, start);
   }
 
   return ant;
@@ -136,19 +142,20 @@ void LinearSolver::SolvePiece(const std::size_t iterations) {
 }
 
 void LinearSolver::SolveSalesman(const std::size_t iterations,
-                                 const std::size_t threads_num) {
+                                 std::size_t threads_num) {
+  if (threads_num == 0) {
+    threads_num = ThreadPool::Instance().Size();
+  }
   std::size_t iters_in_thread =
       (iterations > threads_num) ? iterations / threads_num : 1;
-  std::vector<std::thread> threadVector{};
+  TaskGroup group;
 
   for (std::size_t i = 0; i < threads_num; ++i) {
-    threadVector.push_back(std::thread([this, iters_in_thread]() {
+    group.Run([this, iters_in_thread]() {
       LinearSolver::SolvePiece(iters_in_thread);
-    }));
-  }
-  for (auto &threaD : threadVector) {
-    threaD.join();
+    });
   }
+  group.Wait();
 
   std::for_each(best_result_->vertices_.begin(), best_result_->vertices_.end(),
                 [](int &x) { ++x; });
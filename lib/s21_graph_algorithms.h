@@ -40,17 +40,17 @@ public:
   /// @param matrix weights graph
   /// @param result TsmResult with shortest path and distance. Initially
   /// the distance is set to infinity, shortest path - empty.
-  LinearSolver(m_ptr matrix, std::shared_ptr<TsmResult> result);
+  LinearSolver(const_m_ptr matrix, std::shared_ptr<TsmResult> result);
   ~LinearSolver() = default;
 
   /// @brief launch Salesman problem solving
   /// @param iterations count of iterations
-  /// @param threads count of threads
+  /// @param threads count of threads, 0 - size of the thread pool
   void SolveSalesman(const std::size_t iterations,
-                     const std::size_t threads) override;
+                     std::size_t threads) override;
 
 protected:
-  m_ptr matrix_;
+  const_m_ptr matrix_;
   std::shared_ptr<TsmResult> best_result_;
   m_ptr phero_ptr_;
 
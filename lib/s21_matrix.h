@@ -0,0 +1,337 @@
+#ifndef PARALLELS_SRC_LIB_S21_MATRIX_H_
+#define PARALLELS_SRC_LIB_S21_MATRIX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace s21 {
+
+/// @brief non-owning view of a row or a column of a matrix. Elements are
+/// placed "stride" elements apart from each other.
+template <typename T> class VectorView {
+public:
+  VectorView(T *data, std::size_t size, std::size_t stride = 1)
+      : data_(data), size_(size), stride_(stride){};
+
+  std::size_t size() const { return size_; }
+  std::size_t stride() const { return stride_; }
+  T *data() const { return data_; }
+
+  /// @brief unchecked access
+  T &operator[](std::size_t i) const { return data_[i * stride_]; }
+
+  /// @brief checked access
+  /// @throw std::out_of_range if i >= size
+  T &at(std::size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range("VectorView::at: index out of range");
+    }
+    return data_[i * stride_];
+  }
+
+private:
+  T *data_;
+  std::size_t size_;
+  std::size_t stride_;
+};
+
+/// @brief non-owning strided view of a matrix (or of its block). Cheap to
+/// copy, does not manage the lifetime of the underlying buffer.
+template <typename T> class MatrixView {
+public:
+  MatrixView() = default;
+  MatrixView(T *data, std::size_t rows, std::size_t cols,
+             std::size_t row_stride, std::size_t col_stride = 1)
+      : data_(data), rows_(rows), cols_(cols), row_stride_(row_stride),
+        col_stride_(col_stride){};
+
+  /// @brief allows implicit conversion of MatrixView<T> to
+  /// MatrixView<const T>
+  template <typename U,
+            typename = std::enable_if_t<std::is_same_v<const U, T> &&
+                                        !std::is_same_v<U, T>>>
+  MatrixView(const MatrixView<U> &other)
+      : data_(other.data()), rows_(other.rows()), cols_(other.cols()),
+        row_stride_(other.row_stride()), col_stride_(other.col_stride()){};
+
+  std::size_t rows() const { return rows_; }
+  std::size_t cols() const { return cols_; }
+  std::size_t row_stride() const { return row_stride_; }
+  std::size_t col_stride() const { return col_stride_; }
+  T *data() const { return data_; }
+  bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+  /// @brief unchecked access
+  T &operator()(std::size_t i, std::size_t j) const {
+    return data_[i * row_stride_ + j * col_stride_];
+  }
+
+  /// @brief checked access
+  /// @throw std::out_of_range if indices are out of range
+  T &at(std::size_t i, std::size_t j) const {
+    if (i >= rows_ || j >= cols_) {
+      throw std::out_of_range("MatrixView::at: index out of range");
+    }
+    return (*this)(i, j);
+  }
+
+  VectorView<T> Row(std::size_t i) const {
+    return VectorView<T>(data_ + i * row_stride_, cols_, col_stride_);
+  }
+
+  VectorView<T> Col(std::size_t j) const {
+    return VectorView<T>(data_ + j * col_stride_, rows_, row_stride_);
+  }
+
+  /// @brief returns view of the block [row, row + rows) x [col, col + cols)
+  /// @throw std::out_of_range if the block does not fit into the view
+  MatrixView Block(std::size_t row, std::size_t col, std::size_t rows,
+                   std::size_t cols) const {
+    if (row + rows > rows_ || col + cols > cols_) {
+      throw std::out_of_range("MatrixView::Block: block out of range");
+    }
+    return MatrixView(data_ + row * row_stride_ + col * col_stride_, rows,
+                      cols, row_stride_, col_stride_);
+  }
+
+  /// @brief returns transposed view of the same data (strides are swapped)
+  MatrixView Transposed() const {
+    return MatrixView(data_, cols_, rows_, col_stride_, row_stride_);
+  }
+
+private:
+  T *data_ = nullptr;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t row_stride_ = 0;
+  std::size_t col_stride_ = 1;
+};
+
+/// @brief dense row-major matrix stored in a single buffer aligned to
+/// kAlignment bytes. Every row starts at an aligned address: rows are padded
+/// up to "stride" elements, padding is zero-filled.
+template <typename T> class Matrix {
+  static_assert(std::is_arithmetic_v<T>, "Matrix supports arithmetic types");
+
+public:
+  /// @brief alignment of the buffer and of every row (cache line)
+  static constexpr std::size_t kAlignment = 64;
+
+  /// @brief creates empty matrix 0 x 0
+  Matrix() = default;
+
+  /// @brief creates matrix rows x cols filled with value
+  Matrix(std::size_t rows, std::size_t cols, const T &value = T())
+      : rows_(rows), cols_(cols), stride_(ComputeStride(cols)) {
+    Allocate();
+    Fill(value);
+  }
+
+  /// @brief creates matrix from nested initializer list
+  /// @throw std::invalid_argument if rows have different sizes
+  Matrix(std::initializer_list<std::initializer_list<T>> init)
+      : Matrix(init.size(), init.size() ? init.begin()->size() : 0) {
+    std::size_t i = 0;
+    for (auto &row : init) {
+      if (row.size() != cols_) {
+        throw std::invalid_argument("Matrix: rows have different sizes");
+      }
+      std::copy(row.begin(), row.end(), (*this)[i++]);
+    }
+  }
+
+  /// @brief creates matrix from vector of rows
+  /// @throw std::invalid_argument if rows have different sizes
+  explicit Matrix(const std::vector<std::vector<T>> &init)
+      : Matrix(init.size(), init.empty() ? 0 : init.front().size()) {
+    for (std::size_t i = 0; i < rows_; ++i) {
+      if (init[i].size() != cols_) {
+        throw std::invalid_argument("Matrix: rows have different sizes");
+      }
+      std::copy(init[i].begin(), init[i].end(), (*this)[i]);
+    }
+  }
+
+  Matrix(const Matrix &other)
+      : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_) {
+    Allocate();
+    if (data_ != nullptr) {
+      std::memcpy(data_, other.data_, rows_ * stride_ * sizeof(T));
+    }
+  }
+
+  Matrix(Matrix &&other) noexcept
+      : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+        data_(other.data_), buffer_(std::move(other.buffer_)) {
+    other.rows_ = other.cols_ = other.stride_ = 0;
+    other.data_ = nullptr;
+  }
+
+  Matrix &operator=(const Matrix &other) {
+    if (this != &other) {
+      if (rows_ != other.rows_ || stride_ != other.stride_ ||
+          buffer_.use_count() != 1) {
+        Matrix buff(other);
+        *this = std::move(buff);
+      } else {
+        cols_ = other.cols_;
+        std::memcpy(data_, other.data_, rows_ * stride_ * sizeof(T));
+      }
+    }
+    return *this;
+  }
+
+  Matrix &operator=(Matrix &&other) noexcept {
+    if (this != &other) {
+      rows_ = other.rows_;
+      cols_ = other.cols_;
+      stride_ = other.stride_;
+      data_ = other.data_;
+      buffer_ = std::move(other.buffer_);
+      other.rows_ = other.cols_ = other.stride_ = 0;
+      other.data_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~Matrix() = default;
+
+  /// @brief creates matrix over an external buffer without copying. Rows of
+  /// the buffer must be laid out as in Matrix (aligned, ComputeStride(cols)
+  /// elements apart). "owner" keeps the buffer alive while it is used.
+  /// @throw std::invalid_argument if the buffer is not aligned
+  static Matrix FromBuffer(T *data, std::size_t rows, std::size_t cols,
+                           std::shared_ptr<void> owner) {
+    if (reinterpret_cast<std::uintptr_t>(data) % kAlignment != 0) {
+      throw std::invalid_argument("Matrix::FromBuffer: unaligned buffer");
+    }
+    Matrix result;
+    result.rows_ = rows;
+    result.cols_ = cols;
+    result.stride_ = ComputeStride(cols);
+    result.data_ = data;
+    result.buffer_ = std::move(owner);
+    return result;
+  }
+
+  std::size_t rows() const { return rows_; }
+  std::size_t cols() const { return cols_; }
+  /// @brief distance (in elements) between the beginnings of two rows
+  std::size_t stride() const { return stride_; }
+  /// @brief number of rows. Kept for compatibility with vector of rows
+  std::size_t size() const { return rows_; }
+  bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+
+  /// @brief unchecked access to the beginning of row i
+  T *operator[](std::size_t i) { return data_ + i * stride_; }
+  const T *operator[](std::size_t i) const { return data_ + i * stride_; }
+
+  /// @brief unchecked access to element
+  T &operator()(std::size_t i, std::size_t j) { return data_[i * stride_ + j]; }
+  const T &operator()(std::size_t i, std::size_t j) const {
+    return data_[i * stride_ + j];
+  }
+
+  /// @brief checked access to element
+  /// @throw std::out_of_range if indices are out of range
+  T &at(std::size_t i, std::size_t j) {
+    CheckIndex(i, j);
+    return (*this)(i, j);
+  }
+  const T &at(std::size_t i, std::size_t j) const {
+    CheckIndex(i, j);
+    return (*this)(i, j);
+  }
+
+  /// @brief checked access to row i
+  /// @throw std::out_of_range if i >= rows
+  VectorView<T> at(std::size_t i) {
+    CheckIndex(i, 0);
+    return VectorView<T>((*this)[i], cols_);
+  }
+  VectorView<const T> at(std::size_t i) const {
+    CheckIndex(i, 0);
+    return VectorView<const T>((*this)[i], cols_);
+  }
+
+  MatrixView<T> View() { return MatrixView<T>(data_, rows_, cols_, stride_); }
+  MatrixView<const T> View() const {
+    return MatrixView<const T>(data_, rows_, cols_, stride_);
+  }
+
+  /// @brief returns view of the block [row, row + rows) x [col, col + cols)
+  MatrixView<T> Block(std::size_t row, std::size_t col, std::size_t rows,
+                      std::size_t cols) {
+    return View().Block(row, col, rows, cols);
+  }
+  MatrixView<const T> Block(std::size_t row, std::size_t col,
+                            std::size_t rows, std::size_t cols) const {
+    return View().Block(row, col, rows, cols);
+  }
+
+  /// @brief fills all elements (not the padding) with value
+  void Fill(const T &value) {
+    for (std::size_t i = 0; i < rows_; ++i) {
+      std::fill((*this)[i], (*this)[i] + cols_, value);
+    }
+  }
+
+  /// @brief swaps contents of two rows
+  void SwapRows(std::size_t first, std::size_t second) {
+    if (first != second) {
+      std::swap_ranges((*this)[first], (*this)[first] + cols_,
+                       (*this)[second]);
+    }
+  }
+
+  /// @brief returns row length padded to kAlignment bytes
+  static std::size_t ComputeStride(std::size_t cols) {
+    constexpr std::size_t kStep =
+        (kAlignment % sizeof(T) == 0) ? kAlignment / sizeof(T) : 1;
+    return (cols + kStep - 1) / kStep * kStep;
+  }
+
+private:
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t stride_ = 0;
+  T *data_ = nullptr;
+  std::shared_ptr<void> buffer_;
+
+  void Allocate() {
+    std::size_t bytes = rows_ * stride_ * sizeof(T);
+    if (bytes == 0) {
+      return;
+    }
+    bytes = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    void *ptr = std::aligned_alloc(kAlignment, bytes);
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    std::memset(ptr, 0, bytes);
+    buffer_ = std::shared_ptr<void>(ptr, std::free);
+    data_ = static_cast<T *>(ptr);
+  }
+
+  void CheckIndex(std::size_t i, std::size_t j) const {
+    if (i >= rows_ || j >= cols_) {
+      throw std::out_of_range("Matrix::at: index out of range");
+    }
+  }
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_MATRIX_H_
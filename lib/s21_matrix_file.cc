@@ -0,0 +1,253 @@
+#include "s21_matrix_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace s21 {
+
+namespace {
+
+template <typename T> struct DTypeOf;
+template <> struct DTypeOf<double> {
+  static constexpr std::uint32_t value = MatrixFileHeader::kFloat64;
+};
+template <> struct DTypeOf<float> {
+  static constexpr std::uint32_t value = MatrixFileHeader::kFloat32;
+};
+template <> struct DTypeOf<std::int64_t> {
+  static constexpr std::uint32_t value = MatrixFileHeader::kInt64;
+};
+
+/// @brief maps the whole file into memory. A private mapping is writable
+/// (copy-on-write), a shared one is read-only
+/// @return mapping owner and size of the file
+std::pair<std::shared_ptr<void>, std::size_t>
+MapFile(const std::string &filename, bool shared = false) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("LoadMatrix: can not open " + filename);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < sizeof(MatrixFileHeader)) {
+    close(fd);
+    throw std::runtime_error("LoadMatrix: file is too small " + filename);
+  }
+  std::size_t size = info.st_size;
+  void *addr = shared ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                      : mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("LoadMatrix: can not map " + filename);
+  }
+  return {std::shared_ptr<void>(addr, [size](void *p) { munmap(p, size); }),
+          size};
+}
+
+/// @brief reads and validates the header of mapped file
+template <typename T>
+MatrixFileHeader ReadHeader(const char *bytes, std::size_t size,
+                            const std::string &filename) {
+  MatrixFileHeader header;
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.magic, MatrixFileHeader::kMagic,
+                  sizeof(header.magic)) != 0 ||
+      header.version != MatrixFileHeader::kVersion) {
+    throw std::runtime_error("LoadMatrix: unknown format " + filename);
+  }
+  if (header.dtype != DTypeOf<T>::value) {
+    throw std::runtime_error("LoadMatrix: unexpected dtype " + filename);
+  }
+  if (header.stride < header.cols || header.payload_offset > size ||
+      (header.stride != 0 &&
+       header.rows > (size - header.payload_offset) / sizeof(T) /
+                         header.stride)) {
+    throw std::runtime_error("LoadMatrix: corrupted file " + filename);
+  }
+  // the mapping is page aligned, the offset keeps the payload aligned for T
+  if (header.alignment == 0 || header.alignment % sizeof(T) != 0 ||
+      header.payload_offset < sizeof(MatrixFileHeader) ||
+      header.payload_offset % header.alignment != 0) {
+    throw std::runtime_error("LoadMatrix: misaligned payload " + filename);
+  }
+  return header;
+}
+
+/// @brief header of a file written by SaveMatrix
+template <typename T>
+MatrixFileHeader MakeHeader(std::size_t rows, std::size_t cols) {
+  MatrixFileHeader header = {};
+  std::memcpy(header.magic, MatrixFileHeader::kMagic, sizeof(header.magic));
+  header.version = MatrixFileHeader::kVersion;
+  header.dtype = DTypeOf<T>::value;
+  header.rows = rows;
+  header.cols = cols;
+  header.stride = Matrix<T>::ComputeStride(cols);
+  header.alignment = Matrix<T>::kAlignment;
+  header.payload_offset = sizeof(MatrixFileHeader);
+  return header;
+}
+
+} // namespace
+
+bool IsMatrixFile(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  char magic[sizeof(MatrixFileHeader::kMagic)] = {};
+  file.read(magic, sizeof(magic));
+  return file.gcount() == sizeof(magic) &&
+         std::memcmp(magic, MatrixFileHeader::kMagic, sizeof(magic)) == 0;
+}
+
+template <typename T> Matrix<T> LoadMatrix(const std::string &filename) {
+  auto [mapping, size] = MapFile(filename);
+  auto *bytes = static_cast<char *>(mapping.get());
+  MatrixFileHeader header = ReadHeader<T>(bytes, size, filename);
+  if (header.rows == 0 || header.cols == 0) {
+    return Matrix<T>();
+  }
+
+  auto *payload = reinterpret_cast<T *>(bytes + header.payload_offset);
+  if (header.stride == Matrix<T>::ComputeStride(header.cols) &&
+      reinterpret_cast<std::uintptr_t>(payload) % Matrix<T>::kAlignment ==
+          0) {
+    return Matrix<T>::FromBuffer(payload, header.rows, header.cols,
+                                 std::move(mapping));
+  }
+
+  Matrix<T> result(header.rows, header.cols);
+  for (std::size_t i = 0; i < header.rows; ++i) {
+    std::memcpy(result[i], payload + i * header.stride,
+                header.cols * sizeof(T));
+  }
+  return result;
+}
+
+template <typename T>
+void SaveMatrix(const Matrix<T> &matrix, const std::string &filename) {
+  MatrixFileHeader header = MakeHeader<T>(matrix.rows(), matrix.cols());
+  header.stride = matrix.stride();
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("SaveMatrix: can not open " + filename);
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (matrix.data() != nullptr) {
+    file.write(reinterpret_cast<const char *>(matrix.data()),
+               matrix.rows() * matrix.stride() * sizeof(T));
+  }
+  if (!file) {
+    throw std::runtime_error("SaveMatrix: can not write " + filename);
+  }
+}
+
+template <typename T>
+MappedMatrix<T>::MappedMatrix(const std::string &filename) {
+  auto [mapping, size] = MapFile(filename, true);
+  auto *bytes = static_cast<const char *>(mapping.get());
+  MatrixFileHeader header = ReadHeader<T>(bytes, size, filename);
+  mapping_ = std::move(mapping);
+  if (header.rows != 0 && header.cols != 0) {
+    view_ = MatrixView<const T>(
+        reinterpret_cast<const T *>(bytes + header.payload_offset),
+        header.rows, header.cols, header.stride);
+  }
+}
+
+template <typename T>
+void MappedMatrix<T>::WillNeed(std::size_t start, std::size_t end) const {
+  Advise(start, end, MADV_WILLNEED);
+}
+
+template <typename T>
+void MappedMatrix<T>::DontNeed(std::size_t start, std::size_t end) const {
+  Advise(start, end, MADV_DONTNEED);
+}
+
+template <typename T>
+void MappedMatrix<T>::Advise(std::size_t start, std::size_t end,
+                             int advice) const {
+  end = std::min(end, rows());
+  if (start >= end) {
+    return;
+  }
+  // madvise takes page-aligned ranges, partial pages at the ends are kept
+  const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto first = reinterpret_cast<std::uintptr_t>(view_.data() +
+                                                start * view_.row_stride());
+  auto last = reinterpret_cast<std::uintptr_t>(view_.data() +
+                                               end * view_.row_stride());
+  first = advice == MADV_DONTNEED ? (first + page - 1) / page * page
+                                  : first / page * page;
+  if (first < last) {
+    madvise(reinterpret_cast<void *>(first), last - first, advice);
+  }
+}
+
+template <typename T>
+MatrixFileWriter<T>::MatrixFileWriter(const std::string &filename,
+                                      std::size_t rows, std::size_t cols)
+    : rows_(rows), cols_(cols), stride_(Matrix<T>::ComputeStride(cols)),
+      filename_(filename) {
+  fd_ = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("SaveMatrix: can not open " + filename);
+  }
+  MatrixFileHeader header = MakeHeader<T>(rows, cols);
+  // the payload is a hole of zeros until the blocks are written
+  if (pwrite(fd_, &header, sizeof(header), 0) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      ftruncate(fd_, sizeof(header) + rows * stride_ * sizeof(T)) != 0) {
+    close(fd_);
+    throw std::runtime_error("SaveMatrix: can not write " + filename);
+  }
+}
+
+template <typename T> MatrixFileWriter<T>::~MatrixFileWriter() {
+  close(fd_);
+}
+
+template <typename T>
+void MatrixFileWriter<T>::WriteBlock(std::size_t row, std::size_t col,
+                                     MatrixView<const T> block) {
+  if (row + block.rows() > rows_ || col + block.cols() > cols_ ||
+      block.col_stride() != 1) {
+    throw std::runtime_error("SaveMatrix: block out of range " + filename_);
+  }
+  const std::size_t bytes = block.cols() * sizeof(T);
+  for (std::size_t i = 0; i < block.rows(); ++i) {
+    off_t offset =
+        sizeof(MatrixFileHeader) + ((row + i) * stride_ + col) * sizeof(T);
+    if (pwrite(fd_, &block(i, 0), bytes, offset) !=
+        static_cast<ssize_t>(bytes)) {
+      throw std::runtime_error("SaveMatrix: can not write " + filename_);
+    }
+  }
+}
+
+template class MappedMatrix<double>;
+template class MappedMatrix<float>;
+template class MappedMatrix<std::int64_t>;
+template class MatrixFileWriter<double>;
+template class MatrixFileWriter<float>;
+template class MatrixFileWriter<std::int64_t>;
+
+template Matrix<double> LoadMatrix<double>(const std::string &);
+template Matrix<float> LoadMatrix<float>(const std::string &);
+template Matrix<std::int64_t> LoadMatrix<std::int64_t>(const std::string &);
+template void SaveMatrix<double>(const Matrix<double> &, const std::string &);
+template void SaveMatrix<float>(const Matrix<float> &, const std::string &);
+template void SaveMatrix<std::int64_t>(const Matrix<std::int64_t> &,
+                                       const std::string &);
+
+} // namespace s21
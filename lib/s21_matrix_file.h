@@ -0,0 +1,121 @@
+#ifndef PARALLELS_SRC_LIB_S21_MATRIX_FILE_H_
+#define PARALLELS_SRC_LIB_S21_MATRIX_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "s21_matrix.h"
+
+namespace s21 {
+
+/// @brief binary matrix format. The file consists of the header followed by
+/// the payload: "rows" rows of "stride" elements each, row-major, starting at
+/// "payload_offset". Rows are padded in the same way as in Matrix, so a file
+/// written by SaveMatrix is mapped into memory without copying.
+struct MatrixFileHeader {
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  /// @brief type of elements of the payload
+  enum DType : std::uint32_t { kFloat64 = 1, kFloat32 = 2, kInt64 = 3 };
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t dtype;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  /// @brief number of elements between the beginnings of two rows
+  std::uint64_t stride;
+  /// @brief alignment (in bytes) of the payload and of every row
+  std::uint64_t alignment;
+  /// @brief offset of the payload from the beginning of the file
+  std::uint64_t payload_offset;
+  std::uint64_t reserved;
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "header must take 64 bytes");
+
+/// @brief checks that file starts with the binary matrix magic
+/// @param filename path to file
+/// @return true if file is a binary matrix file
+bool IsMatrixFile(const std::string &filename);
+
+/// @brief loads matrix from binary file. If layout of the payload matches
+/// Matrix<T> (same dtype, stride and alignment) the file is mapped into
+/// memory privately (copy-on-write) and the matrix uses the mapping as its
+/// buffer, otherwise the payload is copied.
+/// @param filename path to file
+/// @return loaded matrix
+/// @throw std::runtime_error if file is missing, corrupted or has other dtype
+template <typename T> Matrix<T> LoadMatrix(const std::string &filename);
+
+/// @brief saves matrix to binary file
+/// @param matrix matrix to be saved
+/// @param filename path to file
+/// @throw std::runtime_error if file can not be written
+template <typename T>
+void SaveMatrix(const Matrix<T> &matrix, const std::string &filename);
+
+/// @brief read-only binary matrix file mapped into memory (shared mapping).
+/// Pages are read from disk on access and can be dropped by the kernel, so
+/// matrices larger than RAM are accessed without loading them
+template <typename T> class MappedMatrix {
+public:
+  /// @brief maps the file
+  /// @param filename path to file
+  /// @throw std::runtime_error if file is missing, corrupted or has other dtype
+  explicit MappedMatrix(const std::string &filename);
+
+  std::size_t rows() const { return view_.rows(); }
+  std::size_t cols() const { return view_.cols(); }
+  bool empty() const { return view_.empty(); }
+
+  /// @brief view of the payload, valid while the object is alive
+  MatrixView<const T> View() const { return view_; }
+
+  /// @brief advises the kernel to read rows [start, end) ahead
+  void WillNeed(std::size_t start, std::size_t end) const;
+
+  /// @brief advises the kernel that rows [start, end) are not needed soon,
+  /// their pages may be dropped
+  void DontNeed(std::size_t start, std::size_t end) const;
+
+private:
+  std::shared_ptr<void> mapping_;
+  MatrixView<const T> view_;
+
+  void Advise(std::size_t start, std::size_t end, int advice) const;
+};
+
+/// @brief binary matrix file written by blocks. The file is created with the
+/// header of SaveMatrix and zero payload, blocks are written in place
+template <typename T> class MatrixFileWriter {
+public:
+  /// @brief creates (truncates) the file
+  /// @param filename path to file
+  /// @param rows rows of matrix
+  /// @param cols cols of matrix
+  /// @throw std::runtime_error if file can not be written
+  MatrixFileWriter(const std::string &filename, std::size_t rows,
+                   std::size_t cols);
+  ~MatrixFileWriter();
+  MatrixFileWriter(const MatrixFileWriter &) = delete;
+  MatrixFileWriter &operator=(const MatrixFileWriter &) = delete;
+
+  /// @brief writes block to [row, row + block.rows) x [col, col + block.cols)
+  /// @throw std::runtime_error if the block does not fit or write fails
+  void WriteBlock(std::size_t row, std::size_t col,
+                  MatrixView<const T> block);
+
+private:
+  int fd_ = -1;
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t stride_;
+  std::string filename_;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_MATRIX_FILE_H_
@@ -0,0 +1,132 @@
+#include "s21_random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+const std::uint32_t kPhiloxM0 = 0xD2511F53;
+const std::uint32_t kPhiloxM1 = 0xCD9E8D57;
+const std::uint32_t kPhiloxW0 = 0x9E3779B9;
+const std::uint32_t kPhiloxW1 = 0xBB67AE85;
+const int kPhiloxRounds = 10;
+
+const double kPi = 3.14159265358979323846;
+
+/// @brief maps 64 random bits to [0, 1) with 53 bits of precision
+double ToUnit(std::uint32_t high, std::uint32_t low) {
+  std::uint64_t bits = (static_cast<std::uint64_t>(high) << 32) | low;
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+} // namespace
+
+Philox::Counter Philox::Generate(Counter counter, Key key) {
+  for (int round = 0; round < kPhiloxRounds; ++round) {
+    std::uint64_t product0 = std::uint64_t(kPhiloxM0) * counter[0];
+    std::uint64_t product1 = std::uint64_t(kPhiloxM1) * counter[2];
+    counter = {std::uint32_t(product1 >> 32) ^ counter[1] ^ key[0],
+               std::uint32_t(product1),
+               std::uint32_t(product0 >> 32) ^ counter[3] ^ key[1],
+               std::uint32_t(product0)};
+    key[0] += kPhiloxW0;
+    key[1] += kPhiloxW1;
+  }
+  return counter;
+}
+
+MatrixGenerator::MatrixGenerator(std::uint64_t seed, std::size_t threads)
+    : key_{static_cast<std::uint32_t>(seed),
+           static_cast<std::uint32_t>(seed >> 32)},
+      threads_(threads ? threads : ThreadPool::Instance().Size()) {}
+
+std::uint64_t MatrixGenerator::RandomSeed() {
+  std::random_device device;
+  return (static_cast<std::uint64_t>(device()) << 32) | device();
+}
+
+void MatrixGenerator::SetDistribution(Distribution distribution, double a,
+                                      double b) {
+  if (distribution == Distribution::kNormal ? b < 0 : b < a) {
+    throw std::invalid_argument("MatrixGenerator: wrong parameters");
+  }
+  if (distribution == Distribution::kInteger) {
+    a = std::ceil(a);
+    b = std::floor(b);
+    if (b < a) {
+      throw std::invalid_argument("MatrixGenerator: no integers in range");
+    }
+  }
+  distribution_ = distribution;
+  a_ = a;
+  b_ = b;
+}
+
+double MatrixGenerator::Value(std::size_t row, std::size_t col) const {
+  auto bits = Philox::Generate({static_cast<std::uint32_t>(col),
+                                static_cast<std::uint32_t>(col >> 32),
+                                static_cast<std::uint32_t>(row),
+                                static_cast<std::uint32_t>(row >> 32)},
+                               key_);
+  double unit = ToUnit(bits[0], bits[1]);
+  switch (distribution_) {
+  case Distribution::kNormal: {
+    double angle = 2 * kPi * ToUnit(bits[2], bits[3]);
+    return a_ + b_ * std::sqrt(-2 * std::log1p(-unit)) * std::cos(angle);
+  }
+  case Distribution::kInteger:
+    return std::min(b_, a_ + std::floor(unit * (b_ - a_ + 1)));
+  default:
+  case Distribution::kUniform:
+    return a_ + unit * (b_ - a_);
+  }
+}
+
+template <typename Function>
+m_dbl_type MatrixGenerator::Fill(std::size_t rows, std::size_t cols,
+                                 const Function &function) const {
+  m_dbl_type result(rows, cols);
+  ParallelFor(0, rows, threads_, [&](std::size_t start, std::size_t end) {
+    for (std::size_t i = start; i < end; ++i) {
+      function(i, result[i]);
+    }
+  });
+  return result;
+}
+
+m_dbl_type MatrixGenerator::Generate(std::size_t rows,
+                                     std::size_t cols) const {
+  return Fill(rows, cols, [this, cols](std::size_t i, double *row) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      row[j] = Value(i, j);
+    }
+  });
+}
+
+m_dbl_type MatrixGenerator::DiagonallyDominant(std::size_t n) const {
+  return Fill(n, n + 1, [this, n](std::size_t i, double *row) {
+    double sum = 0.0;
+    for (std::size_t j = 0; j <= n; ++j) {
+      row[j] = Value(i, j);
+      sum += (j != i && j != n) ? std::fabs(row[j]) : 0.0;
+    }
+    row[i] = sum + std::fabs(row[i]) + 1.0;
+  });
+}
+
+m_dbl_type MatrixGenerator::SymmetricWeights(std::size_t n) const {
+  return Fill(n, n, [this, n](std::size_t i, double *row) {
+    for (std::size_t j = 0; j < n; ++j) {
+      double value = Value(std::min(i, j), std::max(i, j));
+      row[j] = (i == j) ? 0.0 : std::fabs(value);
+    }
+  });
+}
+
+} // namespace s21
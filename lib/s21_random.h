@@ -0,0 +1,87 @@
+#ifndef PARALLELS_SRC_LIB_S21_RANDOM_H_
+#define PARALLELS_SRC_LIB_S21_RANDOM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "s21_types.h"
+
+namespace s21 {
+
+/// @brief Philox4x32-10 counter-based generator (Salmon et al., "Parallel
+/// random numbers: as easy as 1, 2, 3"). The output is a pure function of
+/// the counter and the key, so any element of a random sequence can be
+/// computed independently of the others.
+class Philox {
+public:
+  using Counter = std::array<std::uint32_t, 4>;
+  using Key = std::array<std::uint32_t, 2>;
+
+  /// @brief encrypts counter with key
+  /// @param counter position in the sequence
+  /// @param key stream identifier (seed)
+  /// @return 128 random bits
+  static Counter Generate(Counter counter, Key key);
+};
+
+/// @brief generator of random matrices. Element (i, j) depends only on the
+/// seed and its position, so rows are filled in parallel by the thread pool
+/// and the result for a given seed does not depend on the thread count.
+class MatrixGenerator {
+public:
+  /// @brief distribution of generated values
+  enum class Distribution {
+    kUniform, // real values in [a, b)
+    kNormal,  // real values with mean a and standard deviation b
+    kInteger  // integer values in [a, b]
+  };
+
+  /// @brief ctor
+  /// @param seed seed of the sequence
+  /// @param threads number of parallel parts, 0 - size of the thread pool
+  explicit MatrixGenerator(std::uint64_t seed, std::size_t threads = 0);
+
+  /// @brief returns non-deterministic seed (std::random_device)
+  static std::uint64_t RandomSeed();
+
+  /// @brief sets distribution of generated values (uniform [0, 1) by default)
+  /// @param distribution kind of distribution
+  /// @param a lower bound or mean
+  /// @param b upper bound or standard deviation
+  void SetDistribution(Distribution distribution, double a, double b);
+
+  /// @brief returns value of element (row, col) of the sequence
+  double Value(std::size_t row, std::size_t col) const;
+
+  /// @brief generates matrix with independent elements
+  /// @param rows rows of matrix
+  /// @param cols cols of matrix
+  m_dbl_type Generate(std::size_t rows, std::size_t cols) const;
+
+  /// @brief generates SLE n x (n + 1) with strictly diagonally dominant
+  /// coefficients, so it always has the only solution and Gauss method
+  /// needs no pivoting. The last column holds the free terms
+  /// @param n number of equations
+  m_dbl_type DiagonallyDominant(std::size_t n) const;
+
+  /// @brief generates symmetric n x n matrix of graph weights: zero
+  /// diagonal, absolute values of the distribution elsewhere
+  /// @param n number of vertices
+  m_dbl_type SymmetricWeights(std::size_t n) const;
+
+private:
+  Philox::Key key_;
+  std::size_t threads_;
+  Distribution distribution_ = Distribution::kUniform;
+  double a_ = 0.0;
+  double b_ = 1.0;
+
+  template <typename Function>
+  m_dbl_type Fill(std::size_t rows, std::size_t cols,
+                  const Function &function) const;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_RANDOM_H_
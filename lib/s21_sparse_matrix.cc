@@ -0,0 +1,415 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
+
+namespace s21 {
+
+namespace {
+
+/// @brief bands of rows per thread, rows of sparse matrices differ in work
+constexpr std::size_t kBandsPerThread = 4;
+
+/// @brief number of bands of rows given to t_num threads
+std::size_t BandCount(std::size_t rows, std::size_t t_num) {
+  return std::max<std::size_t>(std::min(rows, t_num * kBandsPerThread), 1);
+}
+
+/// @brief runs worker on t_num threads, the caller is one of them. Workers
+/// take bands from a shared counter, so a band of heavy rows does not hold
+/// up the others
+template <typename Worker>
+void RunWorkers(std::size_t t_num, const Worker &worker) {
+  TaskGroup group;
+  for (std::size_t i = 1; i < t_num; ++i) {
+    group.Run(worker);
+  }
+  worker();
+  group.Wait();
+}
+
+/// @brief rows [start, end) of a sparse product, in CSR arrays
+struct Band {
+  std::vector<std::size_t> row_nnz;
+  std::vector<std::size_t> col_idx;
+  row_type values;
+};
+
+std::string Lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return text;
+}
+
+} // namespace
+
+CsrMatrix::CsrMatrix(std::size_t rows, std::size_t cols,
+                     std::vector<std::size_t> row_ptr,
+                     std::vector<std::size_t> col_idx, row_type values)
+    : rows_(rows), cols_(cols), row_ptr_(std::move(row_ptr)),
+      col_idx_(std::move(col_idx)), values_(std::move(values)) {
+  if (row_ptr_.size() != rows_ + 1 || row_ptr_.front() != 0 ||
+      row_ptr_.back() != values_.size() || col_idx_.size() != values_.size()) {
+    throw "";
+  }
+  for (std::size_t i = 0; i < rows_; ++i) {
+    if (row_ptr_[i] > row_ptr_[i + 1]) {
+      throw "";
+    }
+    for (std::size_t p = row_ptr_[i]; p < row_ptr_[i + 1]; ++p) {
+      if (col_idx_[p] >= cols_ ||
+          (p > row_ptr_[i] && col_idx_[p] <= col_idx_[p - 1])) {
+        throw "";
+      }
+    }
+  }
+}
+
+CsrMatrix CsrMatrix::FromDense(const m_dbl_type &dense) {
+  CsrMatrix result;
+  result.rows_ = dense.rows();
+  result.cols_ = dense.cols();
+  result.row_ptr_.reserve(dense.rows() + 1);
+  for (std::size_t i = 0; i < dense.rows(); ++i) {
+    const double *row = dense[i];
+    for (std::size_t j = 0; j < dense.cols(); ++j) {
+      if (row[j] != 0.0) {
+        result.col_idx_.push_back(j);
+        result.values_.push_back(row[j]);
+      }
+    }
+    result.row_ptr_.push_back(result.values_.size());
+  }
+  return result;
+}
+
+CsrMatrix CsrMatrix::FromTriplets(std::size_t rows, std::size_t cols,
+                                  std::vector<Triplet> triplets) {
+  for (auto &triplet : triplets) {
+    if (triplet.row >= rows || triplet.col >= cols) {
+      throw "";
+    }
+  }
+  std::sort(triplets.begin(), triplets.end(),
+            [](const Triplet &left, const Triplet &right) {
+              return left.row != right.row ? left.row < right.row
+                                           : left.col < right.col;
+            });
+  CsrMatrix result;
+  result.rows_ = rows;
+  result.cols_ = cols;
+  result.row_ptr_.assign(rows + 1, 0);
+  for (std::size_t t = 0; t < triplets.size(); ++t) {
+    if (t > 0 && triplets[t].row == triplets[t - 1].row &&
+        triplets[t].col == triplets[t - 1].col) {
+      result.values_.back() += triplets[t].value;
+      continue;
+    }
+    result.col_idx_.push_back(triplets[t].col);
+    result.values_.push_back(triplets[t].value);
+    ++result.row_ptr_[triplets[t].row + 1];
+  }
+  for (std::size_t i = 0; i < rows; ++i) {
+    result.row_ptr_[i + 1] += result.row_ptr_[i];
+  }
+  return result;
+}
+
+m_dbl_type CsrMatrix::ToDense() const {
+  m_dbl_type result(rows_, cols_);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    for (std::size_t p = row_ptr_[i]; p < row_ptr_[i + 1]; ++p) {
+      result(i, col_idx_[p]) = values_[p];
+    }
+  }
+  return result;
+}
+
+CsrMatrix CsrMatrix::Transposed() const {
+  CsrMatrix result;
+  result.rows_ = cols_;
+  result.cols_ = rows_;
+  result.row_ptr_.assign(cols_ + 1, 0);
+  result.col_idx_.resize(nnz());
+  result.values_.resize(nnz());
+  for (std::size_t col : col_idx_) {
+    ++result.row_ptr_[col + 1];
+  }
+  for (std::size_t j = 0; j < cols_; ++j) {
+    result.row_ptr_[j + 1] += result.row_ptr_[j];
+  }
+  // rows are visited in order, so columns of the result stay sorted
+  std::vector<std::size_t> next(result.row_ptr_.begin(),
+                                result.row_ptr_.end() - 1);
+  for (std::size_t i = 0; i < rows_; ++i) {
+    for (std::size_t p = row_ptr_[i]; p < row_ptr_[i + 1]; ++p) {
+      std::size_t q = next[col_idx_[p]]++;
+      result.col_idx_[q] = i;
+      result.values_[q] = values_[p];
+    }
+  }
+  return result;
+}
+
+double CsrMatrix::Density() const {
+  return empty() ? 0.0 : static_cast<double>(nnz()) / rows_ / cols_;
+}
+
+double Density(const m_dbl_type &matrix) {
+  if (matrix.empty()) {
+    return 0.0;
+  }
+  std::size_t nonzeros = 0;
+  for (std::size_t i = 0; i < matrix.rows(); ++i) {
+    const double *row = matrix[i];
+    nonzeros += matrix.cols() - std::count(row, row + matrix.cols(), 0.0);
+  }
+  return static_cast<double>(nonzeros) / matrix.rows() / matrix.cols();
+}
+
+CsrMatrix LoadMatrixMarket(const std::string &filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("LoadMatrixMarket: can not open " + filename);
+  }
+  std::string line;
+  std::getline(file, line);
+  std::istringstream banner(Lower(line));
+  std::string magic, object, format, field, symmetry;
+  banner >> magic >> object >> format >> field >> symmetry;
+  if (magic != "%%matrixmarket" || object != "matrix" ||
+      format != "coordinate" ||
+      (field != "real" && field != "double" && field != "integer" &&
+       field != "pattern") ||
+      (symmetry != "general" && symmetry != "symmetric" &&
+       symmetry != "skew-symmetric")) {
+    throw std::runtime_error("LoadMatrixMarket: unsupported format " +
+                             filename);
+  }
+  while (std::getline(file, line) &&
+         (line.empty() || line.front() == '%')) {
+  }
+  std::size_t rows = 0, cols = 0, entries = 0;
+  if (!(std::istringstream(line) >> rows >> cols >> entries)) {
+    throw std::runtime_error("LoadMatrixMarket: wrong size line " + filename);
+  }
+
+  const bool pattern = field == "pattern";
+  const double mirror = symmetry == "skew-symmetric" ? -1.0 : 1.0;
+  std::vector<CsrMatrix::Triplet> triplets;
+  triplets.reserve(symmetry == "general" ? entries : 2 * entries);
+  for (std::size_t e = 0; e < entries; ++e) {
+    std::size_t i = 0, j = 0;
+    double value = 1.0;
+    if (!(file >> i >> j) || (!pattern && !(file >> value)) || i == 0 ||
+        j == 0 || i > rows || j > cols) {
+      throw std::runtime_error("LoadMatrixMarket: wrong entry " + filename);
+    }
+    // indices of the file start from 1
+    triplets.push_back({i - 1, j - 1, value});
+    if (symmetry != "general" && i != j) {
+      triplets.push_back({j - 1, i - 1, mirror * value});
+    }
+  }
+  return CsrMatrix::FromTriplets(rows, cols, std::move(triplets));
+}
+
+CsrMatrix MultiplySparse(const CsrMatrix &a, const CsrMatrix &b,
+                         std::size_t t_num) {
+  if (a.cols() != b.rows()) {
+    throw "";
+  }
+  const auto &a_ptr = a.RowPtr();
+  const auto &a_idx = a.ColIdx();
+  const auto &a_val = a.Values();
+  const auto &b_ptr = b.RowPtr();
+  const auto &b_idx = b.ColIdx();
+  const auto &b_val = b.Values();
+
+  const std::size_t rows = a.rows();
+  t_num = std::max<std::size_t>(t_num, 1);
+  const std::size_t bands = BandCount(rows, t_num);
+  std::vector<Band> results(bands);
+  std::atomic<std::size_t> next_band{0};
+  RunWorkers(std::min(t_num, bands), [&]() {
+    S21_TRACE_SCOPE("MultiplySparseRows");
+    // dense accumulator of a row and the list of its touched columns
+    row_type acc(b.cols(), 0.0);
+    std::vector<bool> touched(b.cols(), false);
+    std::vector<std::size_t> cols;
+    for (std::size_t band = next_band++; band < bands; band = next_band++) {
+      Band &out = results[band];
+      for (std::size_t i = rows * band / bands; i < rows * (band + 1) / bands;
+           ++i) {
+        for (std::size_t p = a_ptr[i]; p < a_ptr[i + 1]; ++p) {
+          const double value = a_val[p];
+          const std::size_t k = a_idx[p];
+          for (std::size_t q = b_ptr[k]; q < b_ptr[k + 1]; ++q) {
+            const std::size_t j = b_idx[q];
+            if (!touched[j]) {
+              touched[j] = true;
+              cols.push_back(j);
+            }
+            acc[j] += value * b_val[q];
+          }
+        }
+        std::sort(cols.begin(), cols.end());
+        for (std::size_t j : cols) {
+          out.col_idx.push_back(j);
+          out.values.push_back(acc[j]);
+          acc[j] = 0.0;
+          touched[j] = false;
+        }
+        out.row_nnz.push_back(cols.size());
+        cols.clear();
+      }
+    }
+  });
+
+  std::vector<std::size_t> row_ptr(1, 0);
+  row_ptr.reserve(rows + 1);
+  std::size_t nnz = 0;
+  for (auto &band : results) {
+    nnz += band.values.size();
+  }
+  std::vector<std::size_t> col_idx;
+  row_type values;
+  col_idx.reserve(nnz);
+  values.reserve(nnz);
+  for (auto &band : results) {
+    for (std::size_t count : band.row_nnz) {
+      row_ptr.push_back(row_ptr.back() + count);
+    }
+    col_idx.insert(col_idx.end(), band.col_idx.begin(), band.col_idx.end());
+    values.insert(values.end(), band.values.begin(), band.values.end());
+  }
+  return CsrMatrix(rows, b.cols(), std::move(row_ptr), std::move(col_idx),
+                   std::move(values));
+}
+
+void MultiplySparseDense(const CsrMatrix &a, const m_dbl_type &b,
+                         m_dbl_type &result, std::size_t t_num) {
+  if (a.cols() != b.rows() || result.rows() != a.rows() ||
+      result.cols() != b.cols()) {
+    throw "";
+  }
+  const auto &a_ptr = a.RowPtr();
+  const auto &a_idx = a.ColIdx();
+  const auto &a_val = a.Values();
+  const std::size_t rows = a.rows();
+  const std::size_t cols = b.cols();
+  t_num = std::max<std::size_t>(t_num, 1);
+  const std::size_t bands = BandCount(rows, t_num);
+  std::atomic<std::size_t> next_band{0};
+  RunWorkers(std::min(t_num, bands), [&]() {
+    S21_TRACE_SCOPE("MultiplySparseDenseRows");
+    for (std::size_t band = next_band++; band < bands; band = next_band++) {
+      for (std::size_t i = rows * band / bands; i < rows * (band + 1) / bands;
+           ++i) {
+        double *res = result[i];
+        std::fill(res, res + cols, 0.0);
+        for (std::size_t p = a_ptr[i]; p < a_ptr[i + 1]; ++p) {
+          const double value = a_val[p];
+          const double *row = b[a_idx[p]];
+          for (std::size_t j = 0; j < cols; ++j) {
+            res[j] += value * row[j];
+          }
+        }
+      }
+    }
+  });
+}
+
+void MultiplyDenseSparse(const m_dbl_type &a, const CsrMatrix &b,
+                         m_dbl_type &result, std::size_t t_num) {
+  if (a.cols() != b.rows() || result.rows() != a.rows() ||
+      result.cols() != b.cols()) {
+    throw "";
+  }
+  const auto &b_ptr = b.RowPtr();
+  const auto &b_idx = b.ColIdx();
+  const auto &b_val = b.Values();
+  const std::size_t rows = a.rows();
+  t_num = std::max<std::size_t>(t_num, 1);
+  const std::size_t bands = BandCount(rows, t_num);
+  std::atomic<std::size_t> next_band{0};
+  RunWorkers(std::min(t_num, bands), [&]() {
+    S21_TRACE_SCOPE("MultiplyDenseSparseRows");
+    for (std::size_t band = next_band++; band < bands; band = next_band++) {
+      for (std::size_t i = rows * band / bands; i < rows * (band + 1) / bands;
+           ++i) {
+        const double *row = a[i];
+        double *res = result[i];
+        std::fill(res, res + b.cols(), 0.0);
+        for (std::size_t k = 0; k < a.cols(); ++k) {
+          if (row[k] == 0.0) {
+            continue;
+          }
+          for (std::size_t q = b_ptr[k]; q < b_ptr[k + 1]; ++q) {
+            res[b_idx[q]] += row[k] * b_val[q];
+          }
+        }
+      }
+    }
+  });
+}
+
+SparseVinograd::SparseVinograd(const_m_ptr first, const_m_ptr second,
+                               m_ptr result, std::size_t t_num,
+                               double first_density, double second_density)
+    : first_(first), second_(second), result_(result),
+      threads_num_(std::max<std::size_t>(t_num, 1)) {
+  S21_TRACE_SCOPE("ConvertToCsr");
+  if (first_density < 0.0) {
+    first_density = Density(*first_);
+  }
+  if (second_density < 0.0) {
+    second_density = Density(*second_);
+  }
+  if (first_density <= kSparseDensity) {
+    sparse_first_ = CsrMatrix::FromDense(*first_);
+  }
+  if (second_density <= kSparseDensity) {
+    sparse_second_ = CsrMatrix::FromDense(*second_);
+  }
+  if (sparse_first_.empty() && sparse_second_.empty()) {
+    // dense operands work as sparse x dense, with no gain
+    sparse_first_ = CsrMatrix::FromDense(*first_);
+  }
+}
+
+void SparseVinograd::Multiply() {
+  const bool first = !sparse_first_.empty();
+  const bool second = !sparse_second_.empty();
+  if (first && second) {
+    CsrMatrix product =
+        MultiplySparse(sparse_first_, sparse_second_, threads_num_);
+    result_->Fill(0.0);
+    const auto &ptr = product.RowPtr();
+    for (std::size_t i = 0; i < product.rows(); ++i) {
+      for (std::size_t p = ptr[i]; p < ptr[i + 1]; ++p) {
+        (*result_)(i, product.ColIdx()[p]) = product.Values()[p];
+      }
+    }
+  } else if (first) {
+    MultiplySparseDense(sparse_first_, *second_, *result_, threads_num_);
+  } else {
+    MultiplyDenseSparse(*first_, sparse_second_, *result_, threads_num_);
+  }
+}
+
+bool SparseVinograd::IsSparse(const m_dbl_type &first,
+                              const m_dbl_type &second) {
+  return Density(first) <= kSparseDensity ||
+         Density(second) <= kSparseDensity;
+}
+
+} // namespace s21
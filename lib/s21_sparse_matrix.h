@@ -0,0 +1,132 @@
+#ifndef PARALLELS_SRC_LIB_S21_SPARSE_MATRIX_H_
+#define PARALLELS_SRC_LIB_S21_SPARSE_MATRIX_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "s21_types.h"
+#include "s21_vinograd_algorithms.h"
+
+namespace s21 {
+
+/// @brief sparse matrix in compressed sparse row (CSR) format: nonzeros of
+/// row i are values[row_ptr[i] .. row_ptr[i + 1]) in columns col_idx of the
+/// same range, sorted by column. The compressed sparse column (CSC) form of
+/// a matrix is the CSR form of its transposed (see Transposed).
+class CsrMatrix {
+public:
+  /// @brief element of a matrix given by coordinates
+  struct Triplet {
+    std::size_t row;
+    std::size_t col;
+    double value;
+  };
+
+  /// @brief creates empty matrix 0 x 0
+  CsrMatrix() = default;
+  /// @brief creates matrix from CSR arrays
+  /// @throw if the arrays are inconsistent or columns are not sorted
+  CsrMatrix(std::size_t rows, std::size_t cols,
+            std::vector<std::size_t> row_ptr,
+            std::vector<std::size_t> col_idx, row_type values);
+
+  /// @brief collects nonzeros of dense matrix
+  static CsrMatrix FromDense(const m_dbl_type &dense);
+  /// @brief creates matrix from triplets in any order, duplicates are summed
+  /// @throw if a triplet is out of range
+  static CsrMatrix FromTriplets(std::size_t rows, std::size_t cols,
+                                std::vector<Triplet> triplets);
+
+  m_dbl_type ToDense() const;
+  /// @brief transposed matrix, i.e. CSC arrays of this one
+  CsrMatrix Transposed() const;
+
+  std::size_t rows() const { return rows_; }
+  std::size_t cols() const { return cols_; }
+  /// @brief number of stored elements
+  std::size_t nnz() const { return values_.size(); }
+  bool empty() const { return rows_ == 0 || cols_ == 0; }
+  /// @brief share of stored elements
+  double Density() const;
+
+  const std::vector<std::size_t> &RowPtr() const { return row_ptr_; }
+  const std::vector<std::size_t> &ColIdx() const { return col_idx_; }
+  const row_type &Values() const { return values_; }
+
+private:
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::vector<std::size_t> row_ptr_ = {0};
+  std::vector<std::size_t> col_idx_;
+  row_type values_;
+};
+
+/// @brief share of nonzero elements of dense matrix
+double Density(const m_dbl_type &matrix);
+
+/// @brief loads MatrixMarket coordinate file (real, integer or pattern;
+/// general, symmetric or skew-symmetric)
+/// @param filename path to file
+/// @return loaded matrix
+/// @throw std::runtime_error if file is missing or has unsupported format
+CsrMatrix LoadMatrixMarket(const std::string &filename);
+
+/// @brief sparse x sparse product (Gustavson's row-by-row algorithm). Bands
+/// of rows are spread between threads of the pool
+/// @throw if a.cols != b.rows
+CsrMatrix MultiplySparse(const CsrMatrix &a, const CsrMatrix &b,
+                         std::size_t t_num = 1);
+
+/// @brief sparse x dense product, result rows x b.cols is overwritten
+/// @throw if the shapes do not match
+void MultiplySparseDense(const CsrMatrix &a, const m_dbl_type &b,
+                         m_dbl_type &result, std::size_t t_num = 1);
+
+/// @brief dense x sparse product, result a.rows x b.cols is overwritten
+/// @throw if the shapes do not match
+void MultiplyDenseSparse(const m_dbl_type &a, const CsrMatrix &b,
+                         m_dbl_type &result, std::size_t t_num = 1);
+
+/// @brief multiplication engine for sparse operands (kSparse mode). Operands
+/// with density up to kSparseDensity are converted to CSR once, by the ctor;
+/// the product is computed by MultiplySparse, MultiplySparseDense or
+/// MultiplyDenseSparse and written to the dense result. If both operands are
+/// dense the first one is converted anyway, with no gain.
+class SparseVinograd : public Vinograd {
+public:
+  /// @brief largest density of an operand that is stored as CSR
+  static constexpr double kSparseDensity = 0.05;
+
+  /// @brief ctor
+  /// @param first first matrix
+  /// @param second second matrix
+  /// @param result result matrix
+  /// @param t_num number of threads
+  /// @param first_density density of first if already known, negative -
+  /// computed by the ctor
+  /// @param second_density density of second (see first_density)
+  SparseVinograd(const_m_ptr first, const_m_ptr second, m_ptr result,
+                 std::size_t t_num = 1, double first_density = -1.0,
+                 double second_density = -1.0);
+  ~SparseVinograd() = default;
+
+  void Multiply() override;
+
+  /// @brief checks that at least one of the matrices is sparse enough to be
+  /// multiplied faster in CSR form
+  static bool IsSparse(const m_dbl_type &first, const m_dbl_type &second);
+
+private:
+  const_m_ptr first_;
+  const_m_ptr second_;
+  m_ptr result_;
+  std::size_t threads_num_;
+  /// @brief CSR forms of the sparse operands, empty for dense ones
+  CsrMatrix sparse_first_;
+  CsrMatrix sparse_second_;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_SPARSE_MATRIX_H_
@@ -1,187 +1,357 @@
 #include "s21_storage.h"
 
+#include <algorithm>
 #include <fstream>
-#include <functional>
 #include <iostream>
-#include <random>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#include "s21_random.h"
+#include "s21_text_parser.h"
+#include "s21_thread_pool.h"
+#include "s21_topology.h"
+
 namespace s21 {
 
-m_dbl_type Storage::FillMatrixRandomly(int rows, int cols) {
-  std::random_device rd;
-  std::default_random_engine engine(rd());
-  auto gen = std::bind(std::uniform_real_distribution<>(0, 10000), engine);
+std::size_t Storage::MaxThreadCount() {
+  return std::max(Topology::Instance().HardwareThreads(), kMinThreadLimit);
+}
 
-  m_dbl_type result_ptr(rows, row_type(cols, 0.0));
+m_dbl_type Storage::FillMatrixRandomly(int rows, int cols) {
+  return FillMatrixRandomly(rows, cols, MatrixGenerator::RandomSeed());
+}
 
-  for (auto &row : result_ptr) {
-    std::generate(row.begin(), row.end(), gen);
+m_dbl_type Storage::FillMatrixRandomly(int rows, int cols,
+                                       std::uint64_t seed) {
+  if (rows < 0 || cols < 0) {
+    throw "";
   }
-
-  return result_ptr;
+  MatrixGenerator generator(seed);
+  generator.SetDistribution(MatrixGenerator::Distribution::kUniform, 0, 10000);
+  return generator.Generate(rows, cols);
 }
 
 m_dbl_type Storage::FillMatrixFromFile(std::string filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    throw "fill_matrix_from_file: wrong file";
+  if (IsMatrixFile(filename)) {
+    return LoadMatrixBinary(filename);
   }
 
-  std::size_t vert_num = 0;
-  if (!(file >> vert_num)) {
-    throw "";
-  }
+  return TextParser().ParseFile(filename);
+}
 
-  m_dbl_type adjacency_matrix;
-  int buff_val = 0;
-  while (!file.eof() && adjacency_matrix.size() != vert_num) {
-    row_type buff_vectr;
-    for (std::size_t i = 0; i < vert_num; ++i) {
-      if (!(file >> buff_val)) {
-        throw "";
-      }
+m_dbl_type Storage::LoadMatrixBinary(const std::string &filename) {
+  return LoadMatrix<double>(filename);
+}
 
-      buff_vectr.push_back(buff_val);
-    }
-    adjacency_matrix.push_back(buff_vectr);
-  }
-  file.close();
+void Storage::SaveMatrixBinary(const m_dbl_type &matrix,
+                               const std::string &filename) {
+  SaveMatrix(matrix, filename);
+}
 
-  return adjacency_matrix;
+bool Storage::CheckMatrixGraphCorrectness(const m_dbl_type &matrix) {
+  return Storage::CheckMatrixCorrectness(matrix) &&
+         matrix.rows() == matrix.cols();
 }
 
-bool Storage::CheckMatrixGraphCorrectness(m_dbl_type matrix) {
-  bool answ = Storage::CheckMatrixCorrectness(matrix);
-  if (answ) {
-    for (auto &row : matrix) {
-      if (row.size() != matrix.size()) {
-        answ = false;
-        break;
-      }
-    }
-  }
-  return answ;
+bool Storage::CheckMatrixCorrectness(const m_dbl_type &matrix) {
+  return !matrix.empty();
 }
 
-bool Storage::CheckMatrixCorrectness(m_dbl_type matrix) {
-  bool answ = true;
-  if (matrix.empty()) {
-    answ = false;
-  } else {
-    size_t row_size = matrix.at(0).size();
-    if (row_size == 0) {
-      answ = false;
-    } else {
-      for (auto &row : matrix) {
-        if (row.size() != row_size) {
-          answ = false;
-          break;
-        }
-      }
-    }
-  }
-  return answ;
+bool Storage::CheckForMultiplication(const m_dbl_type &first,
+                                     const m_dbl_type &second) {
+  return Storage::CheckMatrixCorrectness(first) &&
+         Storage::CheckMatrixCorrectness(second) &&
+         first.cols() == second.rows();
 }
 
-bool Storage::CheckForMultiplication(m_dbl_type first, m_dbl_type second) {
-  bool answ = Storage::CheckMatrixCorrectness(first) &&
-              Storage::CheckMatrixCorrectness(second);
-  if (answ) {
-    for (auto &row : first) {
-      if (row.size() != second.size()) {
-        answ = false;
-        break;
-      }
-    }
-  }
-  return answ;
+bool Storage::CheckSleSizeCorrectness(const m_dbl_type &matrix) {
+  return Storage::CheckMatrixCorrectness(matrix) &&
+         matrix.rows() == matrix.cols() - 1;
 }
 
-bool Storage::CheckSleSizeCorrectness(m_dbl_type matrix) {
-  bool answ = Storage::CheckMatrixCorrectness(matrix);
-  if (matrix.size() != (matrix.at(0).size() - 1)) {
-    answ = false;
-  }
-  return answ;
+template <typename T>
+BasicVinogradStorage<T>::BasicVinogradStorage(matrix_type first,
+                                              matrix_type second)
+    : BasicVinogradStorage(std::make_shared<matrix_type>(std::move(first)),
+                           std::make_shared<matrix_type>(std::move(second))) {
+  // the matrices were created by the storage, so they may be changed
+  own_first_ = std::const_pointer_cast<matrix_type>(first_);
+  own_second_ = std::const_pointer_cast<matrix_type>(second_);
 }
 
-VinogradStorage::VinogradStorage(m_dbl_type first, m_dbl_type second)
-    : Storage(), vinograd_(nullptr), th_count_(1) {
-  if (!Storage::CheckForMultiplication(first, second)) {
+template <typename T>
+BasicVinogradStorage<T>::BasicVinogradStorage(const_matrix_ptr first,
+                                              const_matrix_ptr second)
+    : Storage(), first_(first), second_(second), vinograd_(nullptr),
+      th_count_(ThreadPool::Instance().Size()) {
+  if (!first_ || !second_ || first_->empty() || second_->empty() ||
+      first_->cols() != second_->rows()) {
     throw "";
   }
+  result_ = std::make_shared<matrix_type>(first_->rows(), second_->cols());
+}
 
-  first_ = std::make_shared<m_dbl_type>(first);
-  second_ = std::make_shared<m_dbl_type>(second);
-  result_ = (std::make_shared<m_dbl_type>(m_dbl_type(
-      first_->size(), std::vector<double>(second_->at(0).size(), 0))));
+template <typename T> void BasicVinogradStorage<T>::SetStrategy(MultiMode mode) {
+  ResetResult();
+  vinograd_ = CreateEngine(mode);
+  mode_ = mode;
+  engine_stale_ = false;
 }
 
-void VinogradStorage::SetStrategy(MultiMode mode) {
+template <typename T>
+std::shared_ptr<BasicVinograd<T>>
+BasicVinogradStorage<T>::CreateEngine(MultiMode mode) const {
   switch (mode) {
   case (MultiMode::kSimple): {
-    vinograd_ = std::make_shared<SimpleVinograd>(first_, second_, result_);
-    break;
+    return std::make_shared<BasicSimpleVinograd<T>>(first_, second_, result_);
   }
   case (MultiMode::kParallel): {
-    vinograd_ =
-        std::make_shared<ParallelVinograd>(first_, second_, result_, th_count_);
-    break;
+    return std::make_shared<BasicParallelVinograd<T>>(first_, second_,
+                                                      result_, th_count_);
   }
   case (MultiMode::kPipe): {
-    vinograd_ = std::make_shared<PipeVinograd>(first_, second_, result_);
-    break;
+    return std::make_shared<BasicPipeVinograd<T>>(first_, second_, result_,
+                                                  th_count_);
   }
-  default:
-  case (MultiMode::kEnd): {
-    break;
+  case (MultiMode::kBlocked): {
+    if constexpr (std::is_same_v<T, double>) {
+      return std::make_shared<BlockedVinograd>(first_, second_, result_,
+                                               tiles_);
+    }
+    throw "";
   }
+  case (MultiMode::kStrassen): {
+    if constexpr (std::is_same_v<T, double>) {
+      return std::make_shared<StrassenVinograd>(first_, second_, result_,
+                                                cutoff_, th_count_);
+    }
+    throw "";
+  }
+  case (MultiMode::kSparse): {
+    if constexpr (std::is_same_v<T, double>) {
+      return std::make_shared<SparseVinograd>(first_, second_, result_,
+                                              th_count_);
+    }
+    throw "";
+  }
+  case (MultiMode::kAuto): {
+    if constexpr (std::is_same_v<T, double>) {
+      // the densities are passed on, the operands are scanned once
+      const double first_density = Density(*first_);
+      const double second_density = Density(*second_);
+      if (first_density <= SparseVinograd::kSparseDensity ||
+          second_density <= SparseVinograd::kSparseDensity) {
+        return std::make_shared<SparseVinograd>(first_, second_, result_,
+                                                th_count_, first_density,
+                                                second_density);
+      }
+      return CreateEngine(MultiMode::kBlocked);
+    }
+    return CreateEngine(MultiMode::kParallel);
+  }
+  default:
+    throw "";
   }
 }
 
-void VinogradStorage::SetThreadCount(std::size_t t_num) {
-  if (t_num > 6) {
+template <typename T>
+void BasicVinogradStorage<T>::SetThreadCount(std::size_t t_num) {
+  if (t_num > MaxThreadCount()) {
     throw "";
   }
-  th_count_ = t_num;
+  th_count_ = (t_num == 0) ? ThreadPool::Instance().Size() : t_num;
+  incremental_.reset();
 }
 
-void VinogradStorage::Multiply() {
+template <typename T> void BasicVinogradStorage<T>::Multiply() {
   if (vinograd_ == nullptr) {
     throw "";
   }
+  bool changed = !dirty_rows_.empty() || !dirty_cols_.empty();
+  if constexpr (std::is_same_v<T, double>) {
+    if (result_ready_ && changed &&
+        dirty_rows_.size() <= threshold_ * first_->rows() &&
+        dirty_cols_.size() <= threshold_ * second_->cols()) {
+      if (!incremental_) {
+        incremental_ = std::make_shared<IncrementalVinograd>(
+            first_, second_, result_, th_count_);
+      }
+      incremental_->Update(dirty_rows_, dirty_cols_);
+      last_incremental_ = true;
+      ClearChanges();
+      return;
+    }
+  }
+  if (engine_stale_) {
+    vinograd_ = CreateEngine(mode_);
+    engine_stale_ = false;
+  }
   ResetResult();
   vinograd_->Multiply();
+  if (incremental_) {
+    incremental_->Invalidate();
+  }
+  last_incremental_ = false;
+  result_ready_ = true;
+  ClearChanges();
 }
 
-void VinogradStorage::ResetResult() {
-  for (auto &row : *result_) {
-    std::fill(row.begin(), row.end(), 0.0);
+template <typename T>
+void BasicVinogradStorage<T>::SetFirstRow(std::size_t i,
+                                          const vector_type &values) {
+  if (i >= first_->rows() || values.size() != first_->cols()) {
+    throw "";
+  }
+  std::copy(values.begin(), values.end(), Own(first_, own_first_)[i]);
+  first_batch_.reset();
+  OperandChanged();
+  row_changed_.resize(first_->rows(), false);
+  if (!row_changed_[i]) {
+    row_changed_[i] = true;
+    dirty_rows_.push_back(i);
   }
 }
 
-m_dbl_type VinogradStorage::GetResult() const { return *result_; }
+template <typename T>
+void BasicVinogradStorage<T>::SetSecondCol(std::size_t j,
+                                           const vector_type &values) {
+  if (j >= second_->cols() || values.size() != second_->rows()) {
+    throw "";
+  }
+  matrix_type &second = Own(second_, own_second_);
+  for (std::size_t k = 0; k < values.size(); ++k) {
+    second(k, j) = values[k];
+  }
+  second_batch_.reset();
+  OperandChanged();
+  col_changed_.resize(second_->cols(), false);
+  if (!col_changed_[j]) {
+    col_changed_[j] = true;
+    dirty_cols_.push_back(j);
+  }
+}
+
+template <typename T>
+Matrix<T> &BasicVinogradStorage<T>::Own(const_matrix_ptr &matrix,
+                                        matrix_ptr &own) {
+  if (!own) {
+    // engines keep the shared matrix, they are recreated over the copy
+    own = std::make_shared<matrix_type>(*matrix);
+    matrix = own;
+    vinograd_ = CreateEngine(mode_);
+    incremental_.reset();
+    first_batch_.reset();
+    second_batch_.reset();
+  }
+  return *own;
+}
+
+template <typename T> void BasicVinogradStorage<T>::OperandChanged() {
+  // CSR forms of kSparse (and kAuto, which also picks the engine by
+  // density) are made by the engine ctor
+  if (mode_ == MultiMode::kSparse || mode_ == MultiMode::kAuto) {
+    engine_stale_ = true;
+  }
+}
+
+template <typename T> void BasicVinogradStorage<T>::ClearChanges() {
+  dirty_rows_.clear();
+  dirty_cols_.clear();
+  row_changed_.assign(row_changed_.size(), false);
+  col_changed_.assign(col_changed_.size(), false);
+}
+
+template <typename T>
+std::vector<Matrix<T>> BasicVinogradStorage<T>::MultiplyBatch(
+    const std::vector<const_matrix_ptr> &firsts) {
+  if constexpr (std::is_same_v<T, double>) {
+    if (!second_batch_) {
+      second_batch_ = std::make_shared<BatchVinograd>(
+          second_, BatchVinograd::Side::kRight);
+    }
+    return second_batch_->MultiplyBatch(firsts, th_count_);
+  }
+  throw "";
+}
+
+template <typename T>
+std::vector<Matrix<T>> BasicVinogradStorage<T>::MultiplyByBatch(
+    const std::vector<const_matrix_ptr> &seconds) {
+  if constexpr (std::is_same_v<T, double>) {
+    if (!first_batch_) {
+      first_batch_ =
+          std::make_shared<BatchVinograd>(first_, BatchVinograd::Side::kLeft);
+    }
+    return first_batch_->MultiplyBatch(seconds, th_count_);
+  }
+  throw "";
+}
+
+template <typename T> void BasicVinogradStorage<T>::ResetResult() {
+  result_ready_ = false;
+  if (result_->empty()) {
+    // the previous result was taken by TakeResult; engines share result_, so
+    // the matrix is replaced in place
+    *result_ = matrix_type(first_->rows(), second_->cols());
+  } else {
+    result_->Fill(T(0));
+  }
+}
+
+template <typename T>
+const Matrix<T> &BasicVinogradStorage<T>::GetResult() const {
+  return *result_;
+}
+
+template <typename T> Matrix<T> BasicVinogradStorage<T>::TakeResult() {
+  result_ready_ = false;
+  return std::move(*result_);
+}
+
+template <typename T>
+void BasicVinogradStorage<T>::SaveResult(const std::string &filename) const {
+  SaveMatrix(*result_, filename);
+}
+
+template class BasicVinogradStorage<float>;
+template class BasicVinogradStorage<double>;
+template class BasicVinogradStorage<std::int64_t>;
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 GaussStorage::GaussStorage(m_dbl_type first)
-    : Storage(), gauss_(nullptr), th_count_(1) {
+    : Storage(), gauss_(nullptr),
+      workspace_(std::make_shared<GaussWorkspace>()),
+      th_count_(ThreadPool::Instance().Size()) {
   if (!Storage::CheckSleSizeCorrectness(first)) {
     throw "";
   }
-  matrix_ = std::make_shared<m_dbl_type>(first);
-  result_ = std::make_shared<row_type>(row_type(first.at(0).size(), 1.0));
+  result_ = std::make_shared<row_type>(first.cols(), 1.0);
+  workspace_->GetMatrix(first.rows(), first.cols());
+  workspace_->GetVector(first.rows());
+  workspace_->GetIndices(first.rows());
+  matrix_ = std::make_shared<m_dbl_type>(std::move(first));
 }
 
 void GaussStorage::SetStrategy(MultiMode mode) {
   switch (mode) {
   case (MultiMode::kSimple): {
-    gauss_ = std::make_shared<SimpleGauss>(matrix_, result_);
+    gauss_ = std::make_shared<SimpleGauss>(matrix_, result_, workspace_);
     break;
   }
   case (MultiMode::kParallel): {
-    gauss_ = std::make_shared<ParallelGauss>(matrix_, result_, th_count_);
+    gauss_ = std::make_shared<ParallelGauss>(matrix_, result_, th_count_,
+                                             workspace_);
+    break;
+  }
+  case (MultiMode::kBlocked): {
+    gauss_ = std::make_shared<BlockedGauss>(matrix_, result_, th_count_,
+                                            block_, workspace_);
+    break;
+  }
+  case (MultiMode::kTiled): {
+    gauss_ = std::make_shared<TiledGauss>(matrix_, result_, th_count_, tile_,
+                                          workspace_);
     break;
   }
   default:
@@ -189,9 +359,7 @@ void GaussStorage::SetStrategy(MultiMode mode) {
   }
 }
 
-void GaussStorage::ResetResult() {
-  std::fill(result_->begin(), result_->end(), 1.0);
-}
+void GaussStorage::ResetResult() { result_->assign(matrix_->cols(), 1.0); }
 
 void GaussStorage::SolveSle() {
   if (gauss_ == nullptr) {
@@ -201,24 +369,67 @@ void GaussStorage::SolveSle() {
   gauss_->SolveSle();
 }
 
-row_type GaussStorage::GetResult() const { return *result_; }
+row_type GaussStorage::Solve(const row_type &b) {
+  if (b.size() != matrix_->rows()) {
+    throw "";
+  }
+  row_type x(b.size());
+  Factors().Solve(b.data(), x.data());
+  return x;
+}
+
+m_dbl_type GaussStorage::Solve(const m_dbl_type &b) {
+  if (b.rows() != matrix_->rows() || b.cols() == 0) {
+    throw "";
+  }
+  m_dbl_type x(b.rows(), b.cols());
+  Factors().Solve(b, x);
+  return x;
+}
+
+BlockedGauss &GaussStorage::Factors() {
+  if (!lu_) {
+    lu_ = std::make_shared<BlockedGauss>(matrix_, result_, th_count_, block_);
+  }
+  if (!lu_->IsFactored()) {
+    lu_->Factor();
+  }
+  lu_->SetThreadCount(th_count_);
+  return *lu_;
+}
+
+const row_type &GaussStorage::GetResult() const { return *result_; }
+
+row_type GaussStorage::TakeResult() {
+  row_type result = std::move(*result_);
+  result_->clear();
+  return result;
+}
+
+void GaussStorage::SaveResult(const std::string &filename) const {
+  m_dbl_type solution(1, matrix_->rows());
+  std::copy(result_->begin(), result_->begin() + matrix_->rows(), solution[0]);
+  SaveMatrixBinary(solution, filename);
+}
 
 void GaussStorage::SetThreadCount(std::size_t t_num) {
-  if (t_num > 6) {
+  if (t_num > MaxThreadCount()) {
     throw "";
   }
-  th_count_ = t_num;
+  th_count_ = (t_num == 0) ? ThreadPool::Instance().Size() : t_num;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
 SalesmanStorage::SalesmanStorage(m_dbl_type matrix)
-    : Storage(), algorithm_(nullptr) {
-  if (!Storage::CheckMatrixGraphCorrectness(matrix)) {
+    : SalesmanStorage(std::make_shared<const m_dbl_type>(std::move(matrix))) {}
+
+SalesmanStorage::SalesmanStorage(const_m_ptr matrix)
+    : Storage(), matrix_(matrix), algorithm_(nullptr) {
+  if (!matrix_ || !Storage::CheckMatrixGraphCorrectness(*matrix_)) {
     throw "";
   }
-  matrix_ = std::make_shared<m_dbl_type>(matrix);
   best_result_ = std::make_shared<TsmResult>();
 }
 
@@ -250,6 +461,6 @@ void SalesmanStorage::ResetResult() {
   best_result_ = std::make_shared<TsmResult>();
 }
 
-TsmResult SalesmanStorage::GetResult() const { return *best_result_; }
+const TsmResult &SalesmanStorage::GetResult() const { return *best_result_; }
 
 } // namespace s21
\ No newline at end of file
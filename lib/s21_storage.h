@@ -1,20 +1,38 @@
 #ifndef PARALLELS_SRC_LIB_S21_STORAGE_H_
 #define PARALLELS_SRC_LIB_S21_STORAGE_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "s21_gauss_algorithms.h"
 #include "s21_graph_algorithms.h"
+#include "s21_matrix_file.h"
+#include "s21_sparse_matrix.h"
 #include "s21_types.h"
 #include "s21_vinograd_algorithms.h"
+#include "s21_vinograd_batch.h"
 
 namespace s21 {
 
 class Storage {
 public:
-  /// @brief mode of computations
-  enum class MultiMode { kSimple, kParallel, kPipe, kEnd };
+  /// @brief mode of computations. kAuto picks kSparse or kBlocked by density
+  /// of the operands
+  enum class MultiMode {
+    kSimple,
+    kParallel,
+    kPipe,
+    kBlocked,
+    kStrassen,
+    kSparse,
+    kTiled,
+    kAuto,
+    kEnd
+  };
+
+  /// @brief thread counts up to this value are accepted on any machine
+  static constexpr std::size_t kMinThreadLimit = 6;
 
   /// @brief default ctor.
   Storage(){};
@@ -27,109 +45,310 @@ public:
   /// @brief creates matrix of rows x cols (in science consider it cols x rows)
   /// @param rows rows of matrix
   /// @param cols cols of matrix
-  /// @return vector of rows. each row is a vector of cols
+  /// @return matrix rows x cols filled with random values
   static m_dbl_type FillMatrixRandomly(int rows, int cols);
 
-  /// @brief fills matrix from file
+  /// @brief creates reproducible random matrix (see MatrixGenerator). The
+  /// result depends only on the seed, not on the number of threads
+  /// @param rows rows of matrix
+  /// @param cols cols of matrix
+  /// @param seed seed of the sequence
+  /// @return matrix rows x cols filled with values from [0, 10000)
+  static m_dbl_type FillMatrixRandomly(int rows, int cols, std::uint64_t seed);
+
+  /// @brief returns the largest thread count accepted by SetThreadCount:
+  /// number of available CPUs, but not less than kMinThreadLimit
+  static std::size_t MaxThreadCount();
+
+  /// @brief fills matrix from file. Binary matrix files (see
+  /// s21_matrix_file.h) are recognized and loaded by LoadMatrixBinary, text
+  /// files are parsed by TextParser: whitespace-separated or CSV tables,
+  /// square matrices preceded by their size and SLEs rows x (rows + 1)
   /// @param filename path to file
   /// @return filled matrix
   static m_dbl_type FillMatrixFromFile(std::string filename);
 
+  /// @brief loads matrix from binary file. The file is mapped into memory
+  /// and used as the matrix buffer without copying
+  /// @param filename path to file
+  /// @return loaded matrix
+  static m_dbl_type LoadMatrixBinary(const std::string &filename);
+
+  /// @brief saves matrix to binary file
+  /// @param matrix matrix to be saved
+  /// @param filename path to file
+  static void SaveMatrixBinary(const m_dbl_type &matrix,
+                               const std::string &filename);
+
   /// @brief checks that weight matrix has correct size (width = height)
   /// @param matrix checked matrix
   /// @return true if correct, false if not
-  static bool CheckMatrixGraphCorrectness(m_dbl_type matrix);
+  static bool CheckMatrixGraphCorrectness(const m_dbl_type &matrix);
 
-  /// @brief checks if matrix has correct size (that it is a rectangular)
+  /// @brief checks if matrix has correct size (that it is not empty)
   /// @param matrix matrix to be checked
   /// @return true or false
-  static bool CheckMatrixCorrectness(m_dbl_type matrix);
+  static bool CheckMatrixCorrectness(const m_dbl_type &matrix);
 
   /// @brief firstly performs "CheckMatrixCorrectness" and then that rows = cols
   /// - 1 (for linear equation)
   /// @param matrix matrix to be checked
   /// @return true or false
-  static bool CheckSleSizeCorrectness(m_dbl_type matrix);
+  static bool CheckSleSizeCorrectness(const m_dbl_type &matrix);
 
   /// @brief firstly performs "CheckMatrixCorrectness" for matrices and then
   /// checks that first.cols == second.rows
   /// @param first first matrix
   /// @param second second matrix
   /// @return true or false
-  static bool CheckForMultiplication(m_dbl_type first, m_dbl_type second);
+  static bool CheckForMultiplication(const m_dbl_type &first,
+                                     const m_dbl_type &second);
 
 protected:
   virtual void ResetResult() = 0;
 };
 
-class VinogradStorage : public Storage {
+/// @brief storage of matrices for Winograd multiplication with elements of
+/// type T (float, double or std::int64_t). kBlocked, kStrassen and kSparse
+/// modes, batches and incremental updates use double kernels and are
+/// available for double only; the other types recompute the whole result on
+/// Multiply
+template <typename T> class BasicVinogradStorage : public Storage {
 public:
-  /// @brief ctor. Creates init matrices and result matrix (shared ptrs)
+  using matrix_type = Matrix<T>;
+  using matrix_ptr = std::shared_ptr<Matrix<T>>;
+  using const_matrix_ptr = std::shared_ptr<const Matrix<T>>;
+  using vector_type = std::vector<T>;
+
+  /// @brief default share of changed rows and columns recomputed by
+  /// Multiply incrementally
+  static constexpr double kIncrementalThreshold = 0.05;
+
+  /// @brief ctor. Takes ownership of the matrices: pass rvalues (std::move)
+  /// to avoid copying them
+  /// @param first first matrix
+  /// @param second second matrix
+  BasicVinogradStorage(matrix_type first, matrix_type second);
+  /// @brief ctor. Shares the matrices with the caller without copying. They
+  /// must not be changed while the storage is in use
   /// @param first first matrix
   /// @param second second matrix
-  VinogradStorage(m_dbl_type first, m_dbl_type second);
-  ~VinogradStorage() = default;
+  BasicVinogradStorage(const_matrix_ptr first, const_matrix_ptr second);
+  ~BasicVinogradStorage() = default;
 
-  /// @brief returns copy of result matrix
-  /// @return copy of result matrix
-  m_dbl_type GetResult() const;
+  /// @brief returns result matrix without copying. The reference is valid
+  /// until the next Multiply or TakeResult
+  /// @return result matrix
+  const matrix_type &GetResult() const;
+
+  /// @brief moves result matrix out of the storage. The next Multiply
+  /// allocates a new one
+  /// @return result matrix
+  matrix_type TakeResult();
 
   /// @brief sets computation mode
-  /// @param mode kSimple, kParallel, kPipe
+  /// @param mode kSimple, kParallel, kPipe, kBlocked, kStrassen, kSparse,
+  /// kAuto (kParallel for T other than double)
+  /// @throw if the mode is not available for T or is not a Vinograd mode
+  /// (kTiled, kEnd)
   void SetStrategy(MultiMode mode) override;
 
-  /// @brief multiplies two matrices and stores result inside
+  /// @brief sets sizes of blocks for kBlocked mode (applied by SetStrategy)
+  /// @param tiles sizes of blocks, 0 - derived from cache sizes
+  void SetTiles(BlockedVinograd::Tiles tiles) { tiles_ = tiles; }
+
+  /// @brief sets cutoff of kStrassen mode (applied by SetStrategy)
+  /// @param cutoff largest smallest dimension multiplied without recursion
+  void SetStrassenCutoff(std::size_t cutoff) { cutoff_ = cutoff; }
+
+  /// @brief multiplies two matrices and stores result inside. If only rows
+  /// of the first matrix and columns of the second one were changed since
+  /// the previous Multiply (see SetFirstRow, SetSecondCol) and their share
+  /// does not exceed the incremental threshold, only the changed rows and
+  /// columns of the result are recomputed
   void Multiply();
 
+  /// @brief replaces row of the first matrix. A matrix shared with the
+  /// caller is copied on the first change
+  /// @param i index of row
+  /// @param values new values, cols of the first matrix
+  void SetFirstRow(std::size_t i, const vector_type &values);
+
+  /// @brief replaces column of the second matrix (see SetFirstRow)
+  /// @param j index of column
+  /// @param values new values, rows of the second matrix
+  void SetSecondCol(std::size_t j, const vector_type &values);
+
+  /// @brief sets the largest share of changed rows (and of changed columns)
+  /// recomputed incrementally, more changes fall back to full Multiply
+  /// @param share share of rows and columns, 0 - always full Multiply
+  void SetIncrementalThreshold(double share) { threshold_ = share; }
+
+  /// @brief true if the last Multiply recomputed only the changed rows and
+  /// columns, false if it multiplied the whole matrices
+  bool LastUpdateWasIncremental() const { return last_incremental_; }
+
+  /// @brief multiplies every matrix of the batch by the second matrix. The
+  /// second matrix is packed and its factors are computed once, on the
+  /// first call, and reused by later calls. Does not need a strategy
+  /// @param firsts first matrices
+  /// @return products firsts[i] * second in the order of the batch
+  /// @throw if T is not double
+  std::vector<matrix_type>
+  MultiplyBatch(const std::vector<const_matrix_ptr> &firsts);
+
+  /// @brief multiplies the first matrix by every matrix of the batch, the
+  /// first matrix is packed once (see MultiplyBatch)
+  /// @param seconds second matrices
+  /// @return products first * seconds[i] in the order of the batch
+  /// @throw if T is not double
+  std::vector<matrix_type>
+  MultiplyByBatch(const std::vector<const_matrix_ptr> &seconds);
+
+  /// @brief sets number of threads for parallel, pipe, Strassen and batch
+  /// modes
+  /// @param t_num number of threads, 0 - size of the thread pool
   void SetThreadCount(std::size_t t_num);
 
+  /// @brief saves result matrix to binary file
+  /// @param filename path to file
+  void SaveResult(const std::string &filename) const;
+
 protected:
   virtual void ResetResult() override;
 
 private:
-  m_ptr first_;
-  m_ptr second_;
-  m_ptr result_;
-  std::shared_ptr<Vinograd> vinograd_;
+  const_matrix_ptr first_;
+  const_matrix_ptr second_;
+  matrix_ptr result_;
+  std::shared_ptr<BasicVinograd<T>> vinograd_;
   std::size_t th_count_;
+  BlockedVinograd::Tiles tiles_;
+  std::size_t cutoff_ = StrassenVinograd::kDefaultCutoff;
+  std::shared_ptr<BatchVinograd> first_batch_;
+  std::shared_ptr<BatchVinograd> second_batch_;
+  MultiMode mode_ = MultiMode::kEnd;
+
+  /// @brief mutable matrices owned by the storage, null if shared
+  matrix_ptr own_first_;
+  matrix_ptr own_second_;
+  std::shared_ptr<IncrementalVinograd> incremental_;
+  std::vector<std::size_t> dirty_rows_;
+  std::vector<std::size_t> dirty_cols_;
+  std::vector<bool> row_changed_;
+  std::vector<bool> col_changed_;
+  /// @brief result_ holds the product of the matrices before the changes
+  bool result_ready_ = false;
+  /// @brief the engine keeps converted operands (kSparse, kAuto) made
+  /// before the changes, it is recreated by the next full Multiply
+  bool engine_stale_ = false;
+  bool last_incremental_ = false;
+  double threshold_ = kIncrementalThreshold;
+
+  std::shared_ptr<BasicVinograd<T>> CreateEngine(MultiMode mode) const;
+  /// @brief replaces shared matrix by a copy owned by the storage
+  matrix_type &Own(const_matrix_ptr &matrix, matrix_ptr &own);
+  void ClearChanges();
+  /// @brief marks the engine stale if it keeps converted operands
+  void OperandChanged();
 };
 
+extern template class BasicVinogradStorage<float>;
+extern template class BasicVinogradStorage<double>;
+extern template class BasicVinogradStorage<std::int64_t>;
+
+using VinogradStorage = BasicVinogradStorage<double>;
+
 /// @brief class for storing of matrix and result vector for SLE (Gauss method)
 class GaussStorage : public Storage {
 public:
-  /// @brief ctor. Creates matrix and result vector(shared ptrs)
-  /// @param first initial matrix (copied)
+  /// @brief ctor. Creates matrix and result vector(shared ptrs) and the
+  /// workspace of the engines, preallocated for the SLE, so repeated solves
+  /// do not allocate. The storage owns the matrix: pass an rvalue
+  /// (std::move) to avoid copying
+  /// @param first initial matrix
   explicit GaussStorage(m_dbl_type first);
   ~GaussStorage() = default;
 
   /// @brief change computation method
-  /// @param mode method (linear, parallel)
+  /// @param mode method (kSimple, kParallel, kBlocked - blocked LU, kTiled -
+  /// tiled LU scheduled as a task graph)
   void SetStrategy(MultiMode mode) override;
 
+  /// @brief sets columns of a panel of kBlocked mode (applied by
+  /// SetStrategy)
+  /// @param block columns of a panel, 0 - BlockedGauss::kDefaultBlock
+  void SetBlock(std::size_t block) { block_ = block; }
+
+  /// @brief sets size of a tile of kTiled mode (applied by SetStrategy)
+  /// @param tile rows and columns of a tile, 0 - TiledGauss::kDefaultTile
+  void SetTile(std::size_t tile) { tile_ = tile; }
+
   /// @brief reset values of result to 1.0 (for loop computations)
   virtual void ResetResult() override;
 
+  /// @brief sets number of threads for parallel mode
+  /// @param t_num number of threads, 0 - size of the thread pool
   void SetThreadCount(std::size_t t_num);
 
   /// @brief launches SLE
   void SolveSle();
 
-  /// @brief returns result vector
-  /// @return vector of result (copied)
-  row_type GetResult() const;
+  /// @brief solves the system with the coefficients of the SLE and another
+  /// right-hand side. The coefficients are factored (blocked LU) on the
+  /// first call and the factors are reused, so every call only runs forward
+  /// and back substitution, O(n^2)
+  /// @param b right-hand side, rows values
+  /// @return solution, rows values
+  /// @throw if the size of b is wrong, std::runtime_error if the matrix is
+  /// singular
+  row_type Solve(const row_type &b);
+
+  /// @brief solves the system for every column of B (see Solve(b)), the
+  /// columns are substituted in parallel
+  /// @param b right-hand sides, rows x k
+  /// @return solutions, rows x k
+  m_dbl_type Solve(const m_dbl_type &b);
+
+  /// @brief returns result vector without copying. The reference is valid
+  /// until the next SolveSle or TakeResult
+  /// @return vector of result
+  const row_type &GetResult() const;
+
+  /// @brief moves result vector out of the storage
+  /// @return vector of result
+  row_type TakeResult();
+
+  /// @brief saves solution (1 x rows matrix) to binary file
+  /// @param filename path to file
+  void SaveResult(const std::string &filename) const;
 
 private:
   m_ptr matrix_;
   row_ptr result_;
   std::shared_ptr<Gauss> gauss_;
+  /// @brief buffers of the engines of SolveSle
+  workspace_ptr workspace_;
   std::size_t th_count_;
+  std::size_t block_ = 0;
+  std::size_t tile_ = 0;
+  /// @brief factors of the coefficients kept for Solve, in their own
+  /// workspace so that SolveSle does not overwrite them
+  std::shared_ptr<BlockedGauss> lu_;
+
+  BlockedGauss &Factors();
 };
 
 class SalesmanStorage : public Storage {
 public:
-  /// @brief ctor. Creates matrix and TsmResult(shared ptrs)
+  /// @brief ctor. Creates matrix and TsmResult(shared ptrs). Pass an rvalue
+  /// (std::move) to avoid copying the matrix
   /// @param matrix matrix of weights
   explicit SalesmanStorage(m_dbl_type matrix);
+  /// @brief ctor. Shares the matrix of weights with the caller without
+  /// copying. It must not be changed while the storage is in use
+  /// @param matrix matrix of weights
+  explicit SalesmanStorage(const_m_ptr matrix);
   ~SalesmanStorage() = default;
   /// @brief sets computation mode. For salesman storage implemented for
   /// compatibility.
@@ -143,11 +362,11 @@ public:
   /// @brief sets values of best_result to initial
   void ResetResult() override;
   /// @brief returns instance of TsmResult stored in the instance of this class
-  /// @return TsmResult
-  TsmResult GetResult() const;
+  /// @return TsmResult (reference valid until the next ResetResult)
+  const TsmResult &GetResult() const;
 
 private:
-  m_ptr matrix_;
+  const_m_ptr matrix_;
   std::shared_ptr<TsmResult> best_result_;
   std::shared_ptr<GraphAlgorithms> algorithm_;
 };
@@ -0,0 +1,231 @@
+#include "s21_text_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+/// @brief pieces smaller than this are not worth a separate thread
+const std::size_t kMinPieceSize = 1 << 16;
+
+bool IsSeparator(char c, bool csv) {
+  return c == ' ' || c == '\t' || c == '\r' || (csv && (c == ',' || c == ';'));
+}
+
+std::size_t ToCount(double value) {
+  if (value < 0 || std::floor(value) != value) {
+    throw std::runtime_error("TextParser: wrong number of rows");
+  }
+  return static_cast<std::size_t>(value);
+}
+
+std::string ReadBlock(std::ifstream &file, std::size_t size) {
+  std::string block(size, '\0');
+  file.read(block.data(), size);
+  block.resize(file.gcount());
+  return block;
+}
+
+} // namespace
+
+TextParser::TextParser(std::size_t threads, std::size_t block_size)
+    : threads_(threads), block_size_(std::max<std::size_t>(block_size, 1)) {
+  if (threads_ == 0) {
+    threads_ = ThreadPool::Instance().Size();
+  }
+}
+
+m_dbl_type TextParser::ParseFile(const std::string &filename, Shape shape,
+                                 Layout layout) const {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("TextParser: can not open " + filename);
+  }
+
+  Lines lines;
+  std::string carry;
+  std::string block = ReadBlock(file, block_size_);
+  if (layout == Layout::kAuto) {
+    layout = DetectLayout(block);
+  }
+  const bool csv = layout == Layout::kCsv;
+
+  while (!block.empty()) {
+    // the next block is read by a pool task while this one is parsed
+    std::string next;
+    TaskGroup reader;
+    reader.Run([this, &file, &next]() {
+      next = ReadBlock(file, block_size_);
+    });
+    block.insert(0, carry);
+    auto cut = block.rfind('\n');
+    cut = (cut == std::string::npos) ? 0 : cut + 1;
+    carry.assign(block, cut, std::string::npos);
+    ParseBlock(std::string_view(block.data(), cut), csv, lines);
+    reader.Wait();
+    block = std::move(next);
+  }
+  ParseBlock(carry, csv, lines);
+
+  return BuildMatrix(lines, shape);
+}
+
+m_dbl_type TextParser::ParseText(std::string_view text, Shape shape,
+                                 Layout layout) const {
+  if (layout == Layout::kAuto) {
+    layout = DetectLayout(text);
+  }
+  Lines lines;
+  ParseBlock(text, layout == Layout::kCsv, lines);
+  return BuildMatrix(lines, shape);
+}
+
+TextParser::Layout TextParser::DetectLayout(std::string_view text) {
+  auto line = text.substr(0, text.find('\n'));
+  return line.find_first_of(",;") == std::string_view::npos
+             ? Layout::kWhitespace
+             : Layout::kCsv;
+}
+
+void TextParser::ParsePiece(std::string_view piece, bool csv, Lines &lines) {
+  const char *pos = piece.data();
+  const char *end = pos + piece.size();
+
+  while (pos < end) {
+    std::size_t count = 0;
+    while (pos < end && *pos != '\n') {
+      if (IsSeparator(*pos, csv)) {
+        ++pos;
+        continue;
+      }
+      if (*pos == '+') {
+        ++pos;
+      }
+      double value = 0;
+      auto [ptr, ec] = std::from_chars(pos, end, value);
+      if (ec != std::errc() ||
+          (ptr < end && *ptr != '\n' && !IsSeparator(*ptr, csv))) {
+        throw std::runtime_error("TextParser: wrong value");
+      }
+      lines.values.push_back(value);
+      ++count;
+      pos = ptr;
+    }
+    if (count != 0) {
+      lines.sizes.push_back(count);
+    }
+    ++pos;
+  }
+}
+
+void TextParser::ParseBlock(std::string_view block, bool csv,
+                            Lines &lines) const {
+  std::size_t pieces_num = std::min(
+      threads_, std::max<std::size_t>(block.size() / kMinPieceSize, 1));
+  if (pieces_num == 1) {
+    ParsePiece(block, csv, lines);
+    return;
+  }
+
+  std::vector<std::string_view> pieces;
+  std::size_t start = 0;
+  for (std::size_t i = 1; i <= pieces_num && start < block.size(); ++i) {
+    std::size_t end = block.size();
+    if (i != pieces_num) {
+      end = block.find('\n', std::max(start, block.size() * i / pieces_num));
+      end = (end == std::string_view::npos) ? block.size() : end + 1;
+    }
+    pieces.push_back(block.substr(start, end - start));
+    start = end;
+  }
+
+  std::vector<Lines> results(pieces.size());
+  TaskGroup group;
+  for (std::size_t i = 1; i < pieces.size(); ++i) {
+    group.Run([&pieces, &results, csv, i]() {
+      ParsePiece(pieces[i], csv, results[i]);
+    });
+  }
+  ParsePiece(pieces[0], csv, results[0]);
+  group.Wait();
+
+  for (auto &result : results) {
+    lines.values.insert(lines.values.end(), result.values.begin(),
+                        result.values.end());
+    lines.sizes.insert(lines.sizes.end(), result.sizes.begin(),
+                       result.sizes.end());
+  }
+}
+
+m_dbl_type TextParser::BuildMatrix(const Lines &lines, Shape shape) {
+  if (lines.sizes.empty()) {
+    throw std::runtime_error("TextParser: no values");
+  }
+
+  // a header is a positive count alone on the first line; anything else
+  // starts a table (e.g. a single column)
+  const double first = lines.values.front();
+  bool has_header = lines.sizes.front() == 1 && lines.sizes.size() > 1 &&
+                    first > 0 && std::floor(first) == first;
+  if (shape == Shape::kAuto) {
+    shape = Shape::kTable;
+    if (has_header) {
+      std::size_t n = ToCount(first);
+      auto fits_sle = [n](std::size_t size) { return size == n + 1; };
+      bool is_sle =
+          lines.sizes.size() - 1 == n &&
+          std::all_of(lines.sizes.begin() + 1, lines.sizes.end(), fits_sle);
+      if (is_sle) {
+        shape = Shape::kSle;
+      } else if (lines.values.size() - 1 == n * n) {
+        shape = Shape::kSquare;
+      }
+    }
+  }
+
+  if (shape == Shape::kSquare) {
+    std::size_t n = ToCount(lines.values.front());
+    if (lines.values.size() - 1 < n * n) {
+      throw std::runtime_error("TextParser: not enough values");
+    }
+    m_dbl_type result(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      std::copy_n(lines.values.begin() + 1 + i * n, n, result[i]);
+    }
+    return result;
+  }
+
+  std::size_t first_row = 0;
+  if (shape == Shape::kSle && has_header) {
+    if (ToCount(lines.values.front()) != lines.sizes.size() - 1) {
+      throw std::runtime_error("TextParser: wrong number of rows");
+    }
+    first_row = 1;
+  }
+
+  std::size_t rows = lines.sizes.size() - first_row;
+  std::size_t cols = lines.sizes[first_row];
+  if (std::any_of(lines.sizes.begin() + first_row, lines.sizes.end(),
+                  [cols](std::size_t size) { return size != cols; })) {
+    throw std::runtime_error("TextParser: rows have different sizes");
+  }
+  if (shape == Shape::kSle && cols != rows + 1) {
+    throw std::runtime_error("TextParser: SLE must be rows x (rows + 1)");
+  }
+
+  m_dbl_type result(rows, cols);
+  auto value = lines.values.begin() + first_row;
+  for (std::size_t i = 0; i < rows; ++i, value += cols) {
+    std::copy_n(value, cols, result[i]);
+  }
+  return result;
+}
+
+} // namespace s21
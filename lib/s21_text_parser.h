@@ -0,0 +1,81 @@
+#ifndef PARALLELS_SRC_LIB_S21_TEXT_PARSER_H_
+#define PARALLELS_SRC_LIB_S21_TEXT_PARSER_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "s21_types.h"
+
+namespace s21 {
+
+/// @brief parser of matrices stored in text files. The file is read in large
+/// blocks, every block is split on line boundaries into pieces which are
+/// parsed in parallel with std::from_chars. Reading of the next block
+/// overlaps parsing of the current one.
+class TextParser {
+public:
+  /// @brief separators of values in a line
+  enum class Layout {
+    kAuto,       // kCsv if the first line has ',' or ';', else kWhitespace
+    kWhitespace, // spaces and tabs
+    kCsv         // ',' or ';' (spaces and tabs around them are allowed)
+  };
+
+  /// @brief how values of the file form a matrix
+  enum class Shape {
+    kAuto,   // kSle or kSquare if the first line has a single value n and
+             // the rest fits the shape, else kTable
+    kTable,  // every non-empty line is a row, rows have the same size
+    kSquare, // first value is n, then n x n values (line breaks are ignored)
+    kSle     // rows x (rows + 1) table, optionally preceded by a line with
+             // the number of rows
+  };
+
+  static constexpr std::size_t kDefaultBlockSize = 1 << 22;
+
+  /// @brief ctor
+  /// @param threads number of pool threads for parsing, 0 - size of the
+  /// thread pool
+  /// @param block_size size (in bytes) of blocks read from file
+  explicit TextParser(std::size_t threads = 0,
+                      std::size_t block_size = kDefaultBlockSize);
+
+  /// @brief parses text file
+  /// @param filename path to file
+  /// @param shape how values form a matrix
+  /// @param layout separators of values
+  /// @return parsed matrix
+  /// @throw std::runtime_error if file can not be read or has wrong format
+  m_dbl_type ParseFile(const std::string &filename, Shape shape = Shape::kAuto,
+                       Layout layout = Layout::kAuto) const;
+
+  /// @brief parses text which is already in memory
+  /// @param text text to be parsed
+  /// @param shape how values form a matrix
+  /// @param layout separators of values
+  /// @return parsed matrix
+  /// @throw std::runtime_error if text has wrong format
+  m_dbl_type ParseText(std::string_view text, Shape shape = Shape::kAuto,
+                       Layout layout = Layout::kAuto) const;
+
+private:
+  /// @brief values of parsed lines: sizes of non-empty lines and their values
+  struct Lines {
+    std::vector<double> values;
+    std::vector<std::size_t> sizes;
+  };
+
+  std::size_t threads_;
+  std::size_t block_size_;
+
+  static Layout DetectLayout(std::string_view text);
+  static void ParsePiece(std::string_view piece, bool csv, Lines &lines);
+  void ParseBlock(std::string_view block, bool csv, Lines &lines) const;
+  static m_dbl_type BuildMatrix(const Lines &lines, Shape shape);
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_TEXT_PARSER_H_
@@ -0,0 +1,371 @@
+#include "s21_thread_pool.h"
+
+#include <chrono>
+
+namespace s21 {
+
+namespace {
+
+/// @brief pool and index of the worker running in the current thread
+thread_local ThreadPool *tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+/// @brief how long a waiting thread sleeps before looking for tasks again
+const std::chrono::microseconds kWaitTimeout(100);
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  Start(threads ? threads : Topology::Instance().HardwareThreads(), {});
+}
+
+ThreadPool::~ThreadPool() { Stop(); }
+
+void ThreadPool::Configure(std::size_t threads, Affinity affinity,
+                           bool use_smt) {
+  std::vector<int> cpus;
+  if (affinity != Affinity::kNone) {
+    cpus = Topology::Instance().Placement(affinity, use_smt);
+  }
+  if (threads == 0) {
+    threads = cpus.empty() ? Topology::Instance().HardwareThreads()
+                           : cpus.size();
+  }
+  Stop();
+  Start(threads, cpus);
+}
+
+void ThreadPool::Start(std::size_t threads, const std::vector<int> &cpus) {
+  threads = std::max<std::size_t>(threads, 1);
+  stop_ = false;
+  cpus_ = cpus;
+  queues_.clear();
+  for (std::size_t i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (std::size_t i = 0; i < threads; ++i) {
+    int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i, cpu);
+  }
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mtx_);
+    stop_ = true;
+  }
+  wake_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+ThreadPool &ThreadPool::Instance() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::Submit(Task task) {
+  std::size_t index = (tls_pool == this)
+                          ? tls_index
+                          : next_queue_.fetch_add(1) % queues_.size();
+  ++pending_;
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mtx);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mtx_);
+  }
+  wake_cv_.notify_one();
+}
+
+bool ThreadPool::RunPendingTask() {
+  std::size_t index = (tls_pool == this) ? tls_index : 0;
+  Task task;
+  if (!PopTask(index, task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+bool ThreadPool::PopTask(std::size_t index, Task &task) {
+  if (pending_ == 0) {
+    return false;
+  }
+  if (tls_pool == this) {
+    Queue &own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mtx);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      --pending_;
+      return true;
+    }
+  }
+  for (std::size_t i = 0; i < queues_.size(); ++i) {
+    Queue &victim = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mtx);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      --pending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(std::size_t index, int cpu) {
+  tls_pool = this;
+  tls_index = index;
+  if (cpu >= 0) {
+    PinCurrentThread(cpu);
+  }
+  while (true) {
+    Task task;
+    if (PopTask(index, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wake_mtx_);
+    wake_cv_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      break;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+TaskGroup::~TaskGroup() { WaitAll(); }
+
+void TaskGroup::Run(std::function<void()> task) {
+  ++pending_;
+  pool_.Submit([this, task = std::move(task)]() {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (--pending_ == 0) {
+      cv_.notify_all();
+    }
+  });
+}
+
+void TaskGroup::Wait() {
+  WaitAll();
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGroup::WaitAll() {
+  while (pending_ > 0) {
+    if (pool_.RunPendingTask()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait_for(lock, kWaitTimeout, [this]() { return pending_ == 0; });
+  }
+  // the last task may still hold the mutex while notifying
+  std::lock_guard<std::mutex> lock(mtx_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+TaskGraph::TaskId TaskGraph::Add(std::function<void()> task,
+                                 const std::vector<TaskId> &dependencies) {
+  const TaskId id = nodes_.size();
+  for (TaskId dependency : dependencies) {
+    if (dependency >= id) {
+      throw "";
+    }
+  }
+  for (TaskId dependency : dependencies) {
+    nodes_[dependency].successors.push_back(id);
+  }
+  Node node;
+  node.task = std::move(task);
+  node.dependencies = dependencies.size();
+  nodes_.push_back(std::move(node));
+  return id;
+}
+
+void TaskGraph::Run(std::size_t threads) {
+  if (nodes_.empty()) {
+    return;
+  }
+  // every task is ready at most once, so the heap never grows past this
+  ready_.clear();
+  ready_.reserve(nodes_.size());
+  for (TaskId id = 0; id < nodes_.size(); ++id) {
+    nodes_[id].remaining = nodes_[id].dependencies;
+    if (nodes_[id].remaining == 0) {
+      // ids are increasing, so the vector is already a min-heap
+      ready_.push_back(id);
+    }
+  }
+  unfinished_ = nodes_.size();
+  error_ = nullptr;
+
+  TaskGroup group(pool_);
+  threads = std::min(std::max<std::size_t>(threads, 1), nodes_.size());
+  for (std::size_t i = 1; i < threads; ++i) {
+    group.Run([this]() { WorkerLoop(); });
+  }
+  WorkerLoop();
+  group.Wait();
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGraph::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (true) {
+    // a worker waits only while another one runs a task, which makes
+    // progress, so workers waiting on the pool cannot deadlock
+    cv_.wait(lock, [this]() {
+      return !ready_.empty() || unfinished_ == 0 || error_;
+    });
+    if (unfinished_ == 0 || error_) {
+      return;
+    }
+    std::pop_heap(ready_.begin(), ready_.end(), std::greater<TaskId>());
+    const TaskId id = ready_.back();
+    ready_.pop_back();
+    lock.unlock();
+    try {
+      nodes_[id].task();
+    } catch (...) {
+      lock.lock();
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      cv_.notify_all();
+      return;
+    }
+    lock.lock();
+    --unfinished_;
+    std::size_t released = 0;
+    for (TaskId successor : nodes_[id].successors) {
+      if (--nodes_[successor].remaining == 0) {
+        ready_.push_back(successor);
+        std::push_heap(ready_.begin(), ready_.end(), std::greater<TaskId>());
+        ++released;
+      }
+    }
+    // this worker takes one of the released tasks itself
+    if (unfinished_ == 0 || released > 1) {
+      cv_.notify_all();
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+ThreadTeam::ThreadTeam(std::size_t size, const std::vector<int> &cpus)
+    : cpus_(cpus) {
+  for (std::size_t id = 1; id < size; ++id) {
+    int cpu = cpus_.empty() ? -1 : cpus_[id % cpus_.size()];
+    threads_.emplace_back(&ThreadTeam::MemberLoop, this, id, cpu);
+  }
+}
+
+ThreadTeam::~ThreadTeam() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadTeam::RunErased(const void *callable, Invoker invoker) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    callable_ = callable;
+    invoker_ = invoker;
+    running_ = threads_.size();
+    error_ = nullptr;
+    ++generation_;
+  }
+  start_cv_.notify_all();
+  Invoke(0);
+  std::unique_lock<std::mutex> lock(mtx_);
+  done_cv_.wait(lock, [this]() { return running_ == 0; });
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadTeam::Invoke(std::size_t id) {
+  try {
+    invoker_(callable_, id);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!error_) {
+      error_ = std::current_exception();
+    }
+  }
+}
+
+void ThreadTeam::MemberLoop(std::size_t id, int cpu) {
+  if (cpu >= 0) {
+    PinCurrentThread(cpu);
+  }
+  std::size_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      start_cv_.wait(lock, [this, generation]() {
+        return stop_ || generation_ != generation;
+      });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+    }
+    Invoke(id);
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (--running_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void Barrier::ArriveAndWait() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  const std::size_t generation = generation_;
+  if (++arrived_ == count_) {
+    arrived_ = 0;
+    ++generation_;
+    cv_.notify_all();
+    return;
+  }
+  cv_.wait(lock, [this, generation]() { return generation_ != generation; });
+}
+
+} // namespace s21
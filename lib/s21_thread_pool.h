@@ -0,0 +1,269 @@
+#ifndef PARALLELS_SRC_LIB_S21_THREAD_POOL_H_
+#define PARALLELS_SRC_LIB_S21_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "s21_topology.h"
+
+namespace s21 {
+
+/// @brief persistent pool of worker threads with work stealing. Every worker
+/// owns a deque of tasks: it pops its own tasks from the back (LIFO) and
+/// steals tasks of other workers from the front (FIFO). Tasks submitted from
+/// outside of the pool are spread between the deques round-robin.
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /// @brief ctor. Launches worker threads
+  /// @param threads number of workers, 0 - number of available CPUs
+  explicit ThreadPool(std::size_t threads = 0);
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+  /// @brief finishes queued tasks and joins workers
+  ~ThreadPool();
+
+  /// @brief process-wide pool shared by all parallel algorithms
+  static ThreadPool &Instance();
+
+  /// @brief number of workers
+  std::size_t Size() const { return workers_.size(); }
+
+  /// @brief CPUs the workers are pinned to (worker i - cpu i % size), empty
+  /// if they are not pinned
+  const std::vector<int> &Cpus() const { return cpus_; }
+
+  /// @brief restarts workers with another count and placement. Queued tasks
+  /// are finished first. Must not be called from a worker or while tasks
+  /// are submitted from other threads
+  /// @param threads number of workers, 0 - number of CPUs in the placement
+  /// @param affinity placement of workers (see Topology::Placement)
+  /// @param use_smt if false, only one SMT sibling of every core is used
+  void Configure(std::size_t threads, Affinity affinity = Affinity::kNone,
+                 bool use_smt = true);
+
+  /// @brief enqueues task. Exceptions must be handled by the task itself
+  /// (use TaskGroup to propagate them)
+  void Submit(Task task);
+
+  /// @brief executes one queued task in the calling thread, if any. Used by
+  /// threads waiting for their tasks so that they help instead of blocking
+  /// @return true if a task was executed
+  bool RunPendingTask();
+
+private:
+  struct Queue {
+    std::mutex mtx;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::vector<int> cpus_;
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<std::size_t> next_queue_{0};
+  std::mutex wake_mtx_;
+  std::condition_variable wake_cv_;
+  bool stop_ = false;
+
+  void Start(std::size_t threads, const std::vector<int> &cpus);
+  void Stop();
+  bool PopTask(std::size_t index, Task &task);
+  void WorkerLoop(std::size_t index, int cpu);
+};
+
+/// @brief group of tasks executed by a ThreadPool (fork-join). Wait blocks
+/// until all tasks of the group are finished and rethrows the first
+/// exception thrown by them. The waiting thread executes queued tasks
+/// meanwhile, so groups may be nested.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool = ThreadPool::Instance())
+      : pool_(pool){};
+  TaskGroup(const TaskGroup &other) = delete;
+  TaskGroup &operator=(const TaskGroup &other) = delete;
+  ~TaskGroup();
+
+  /// @brief submits task to the pool
+  void Run(std::function<void()> task);
+
+  /// @brief waits for all submitted tasks
+  /// @throw first exception thrown by a task of the group
+  void Wait();
+
+private:
+  ThreadPool &pool_;
+  std::atomic<std::size_t> pending_{0};
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::exception_ptr error_;
+
+  void WaitAll();
+};
+
+/// @brief graph of tasks with explicit dependencies (task DAG). Run starts a
+/// number of workers on the pool; they take ready tasks (all dependencies
+/// finished) from a common queue, lowest id first, so independent tasks of
+/// different stages run out of order while the earliest added ones keep
+/// priority. The graph may be run many times.
+class TaskGraph {
+public:
+  using TaskId = std::size_t;
+
+  explicit TaskGraph(ThreadPool &pool = ThreadPool::Instance())
+      : pool_(pool){};
+  TaskGraph(const TaskGraph &other) = delete;
+  TaskGraph &operator=(const TaskGraph &other) = delete;
+
+  /// @brief adds task to the graph
+  /// @param task callable
+  /// @param dependencies ids of tasks finished before this one starts
+  /// @return id of the task
+  /// @throw if a dependency is not added yet (the graph stays acyclic)
+  TaskId Add(std::function<void()> task,
+             const std::vector<TaskId> &dependencies = {});
+
+  /// @brief number of tasks
+  std::size_t Size() const { return nodes_.size(); }
+
+  /// @brief executes all tasks and waits for them. The calling thread is
+  /// one of the workers. After an exception the remaining tasks are skipped
+  /// @param threads number of workers
+  /// @throw first exception thrown by a task
+  void Run(std::size_t threads);
+
+private:
+  struct Node {
+    std::function<void()> task;
+    std::vector<TaskId> successors;
+    std::size_t dependencies = 0;
+    std::size_t remaining = 0;
+  };
+
+  ThreadPool &pool_;
+  std::vector<Node> nodes_;
+  /// @brief min-heap of ready tasks, its capacity is kept between runs
+  std::vector<TaskId> ready_;
+  std::size_t unfinished_ = 0;
+  std::exception_ptr error_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+
+  void WorkerLoop();
+};
+
+/// @brief reusable barrier of a fixed team of threads. Threads of the team
+/// must run at the same time, so the team is made of dedicated threads
+/// (ThreadTeam), not of pool tasks (a waiting task would block its worker)
+class Barrier {
+public:
+  /// @brief ctor
+  /// @param count number of threads of the team
+  explicit Barrier(std::size_t count) : count_(count){};
+  Barrier(const Barrier &other) = delete;
+  Barrier &operator=(const Barrier &other) = delete;
+
+  /// @brief blocks until all threads of the team arrive
+  void ArriveAndWait();
+
+private:
+  std::size_t count_;
+  std::size_t arrived_ = 0;
+  std::size_t generation_ = 0;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+/// @brief fixed team of dedicated threads that run one function together,
+/// e.g. a loop stepped by a Barrier. The threads are started once and wait
+/// between runs, so repeated runs create no threads. The threads are not
+/// workers of the pool, pass ThreadPool::Cpus to pin them like the workers.
+class ThreadTeam {
+public:
+  /// @brief ctor. Starts size - 1 threads, the caller of Run is member 0
+  /// @param size number of members
+  /// @param cpus CPUs of the members (member id - cpu id % size), empty -
+  /// no pinning
+  explicit ThreadTeam(std::size_t size, const std::vector<int> &cpus = {});
+  ThreadTeam(const ThreadTeam &other) = delete;
+  ThreadTeam &operator=(const ThreadTeam &other) = delete;
+  /// @brief stops and joins the threads
+  ~ThreadTeam();
+
+  /// @brief number of members
+  std::size_t Size() const { return threads_.size() + 1; }
+
+  /// @brief CPUs of the members given to the ctor
+  const std::vector<int> &Cpus() const { return cpus_; }
+
+  /// @brief calls function(id) for every member id at the same time and
+  /// waits for all of them. Must not be called by two threads at once
+  /// @param function callable taking the id of the member
+  /// @throw first exception thrown by a member
+  template <typename Function> void Run(const Function &function) {
+    RunErased(&function, [](const void *callable, std::size_t id) {
+      (*static_cast<const Function *>(callable))(id);
+    });
+  }
+
+private:
+  using Invoker = void (*)(const void *, std::size_t);
+
+  std::vector<std::thread> threads_;
+  std::vector<int> cpus_;
+  std::mutex mtx_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const void *callable_ = nullptr;
+  Invoker invoker_ = nullptr;
+  std::size_t generation_ = 0;
+  std::size_t running_ = 0;
+  std::exception_ptr error_;
+  bool stop_ = false;
+
+  void RunErased(const void *callable, Invoker invoker);
+  void Invoke(std::size_t id);
+  void MemberLoop(std::size_t id, int cpu);
+};
+
+/// @brief splits [begin, end) into "parts" contiguous ranges and calls
+/// function(start, end) for each of them in parallel. The first range is
+/// processed by the calling thread.
+/// @param begin start of range
+/// @param end end of range
+/// @param parts number of ranges
+/// @param function callable taking (start, end)
+template <typename Function>
+void ParallelFor(std::size_t begin, std::size_t end, std::size_t parts,
+                 const Function &function) {
+  if (end <= begin) {
+    return;
+  }
+  parts = std::max<std::size_t>(std::min(parts, end - begin), 1);
+  std::size_t step = (end - begin) / parts;
+  std::size_t remainder = (end - begin) % parts;
+
+  TaskGroup group;
+  std::size_t start = begin + step + (remainder > 0 ? 1 : 0);
+  for (std::size_t i = 1; i < parts; ++i) {
+    std::size_t stop = start + step + (i < remainder ? 1 : 0);
+    group.Run([&function, start, stop]() { function(start, stop); });
+    start = stop;
+  }
+  function(begin, begin + step + (remainder > 0 ? 1 : 0));
+  group.Wait();
+}
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_THREAD_POOL_H_
@@ -0,0 +1,202 @@
+#include "s21_topology.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+namespace s21 {
+
+namespace {
+
+const char kSysCpuPath[] = "/sys/devices/system/cpu/cpu";
+
+bool ReadInt(const std::string &path, int &value) {
+  std::ifstream file(path);
+  return static_cast<bool>(file >> value);
+}
+
+/// @brief parses lists like "0-3,8,10-11"
+std::vector<int> ReadCpuList(const std::string &path) {
+  std::vector<int> result;
+  std::ifstream file(path);
+  std::string item;
+  while (std::getline(file, item, ',')) {
+    int first = 0;
+    int last = 0;
+    char dash = 0;
+    std::istringstream range(item);
+    if (!(range >> first)) {
+      continue;
+    }
+    last = (range >> dash >> last && dash == '-') ? last : first;
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+/// @brief parses sizes like "48K", "2048K" or "105M"
+bool ReadSize(const std::string &path, std::size_t &size) {
+  std::ifstream file(path);
+  std::size_t value = 0;
+  char suffix = 0;
+  if (!(file >> value)) {
+    return false;
+  }
+  file >> suffix;
+  size = value << (suffix == 'K' ? 10 : suffix == 'M' ? 20 : 0);
+  return true;
+}
+
+} // namespace
+
+Topology::Topology(std::vector<CpuInfo> cpus, CacheSizes caches)
+    : cpus_(std::move(cpus)), caches_(caches) {
+  if (cpus_.empty()) {
+    cpus_.push_back(CpuInfo());
+  }
+}
+
+const Topology &Topology::Instance() {
+  static const Topology topology = []() {
+    auto cpus = ReadCpus();
+    int first = cpus.empty() ? 0 : cpus.front().cpu;
+    return Topology(std::move(cpus), ReadCaches(first));
+  }();
+  return topology;
+}
+
+std::vector<CpuInfo> Topology::ReadCpus() {
+  std::vector<int> allowed;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        allowed.push_back(cpu);
+      }
+    }
+  } else {
+    for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+      allowed.push_back(cpu);
+    }
+  }
+
+  std::vector<CpuInfo> cpus;
+  for (int cpu : allowed) {
+    CpuInfo info;
+    info.cpu = cpu;
+    info.core = cpu;
+    std::string dir = kSysCpuPath + std::to_string(cpu) + "/topology/";
+    ReadInt(dir + "physical_package_id", info.package);
+    ReadInt(dir + "core_id", info.core);
+    auto siblings = ReadCpuList(dir + "thread_siblings_list");
+    auto pos = std::find(siblings.begin(), siblings.end(), cpu);
+    info.smt = (pos == siblings.end()) ? 0 : pos - siblings.begin();
+    cpus.push_back(info);
+  }
+  return cpus;
+}
+
+CacheSizes Topology::ReadCaches(int cpu) {
+  CacheSizes caches;
+  std::string dir = kSysCpuPath + std::to_string(cpu) + "/cache/index";
+  for (int index = 0;; ++index) {
+    std::string prefix = dir + std::to_string(index) + "/";
+    int level = 0;
+    std::string type;
+    std::size_t size = 0;
+    std::ifstream type_file(prefix + "type");
+    if (!ReadInt(prefix + "level", level) || !(type_file >> type) ||
+        !ReadSize(prefix + "size", size)) {
+      break;
+    }
+    if (type == "Instruction" || size == 0) {
+      continue;
+    }
+    if (level == 1) {
+      caches.l1 = size;
+    } else if (level == 2) {
+      caches.l2 = size;
+    } else if (level == 3) {
+      caches.l3 = size;
+    }
+  }
+  return caches;
+}
+
+std::vector<int> Topology::Placement(Affinity mode, bool use_smt) const {
+  std::vector<CpuInfo> cpus;
+  std::copy_if(cpus_.begin(), cpus_.end(), std::back_inserter(cpus),
+               [use_smt](const CpuInfo &info) {
+                 return use_smt || info.smt == 0;
+               });
+
+  if (mode == Affinity::kCompact) {
+    std::sort(cpus.begin(), cpus.end(),
+              [](const CpuInfo &a, const CpuInfo &b) {
+                return std::tie(a.package, a.core, a.smt, a.cpu) <
+                       std::tie(b.package, b.core, b.smt, b.cpu);
+              });
+  } else if (mode == Affinity::kScatter) {
+    // core ids are not contiguous, so cores are ranked inside every package
+    std::map<int, std::set<int>> cores;
+    for (auto &info : cpus_) {
+      cores[info.package].insert(info.core);
+    }
+    auto rank = [&cores](const CpuInfo &info) {
+      auto &package = cores[info.package];
+      return std::distance(package.begin(), package.find(info.core));
+    };
+    std::sort(cpus.begin(), cpus.end(),
+              [&rank](const CpuInfo &a, const CpuInfo &b) {
+                return std::make_tuple(a.smt, rank(a), a.package, a.cpu) <
+                       std::make_tuple(b.smt, rank(b), b.package, b.cpu);
+              });
+  }
+
+  std::vector<int> result;
+  for (auto &info : cpus) {
+    result.push_back(info.cpu);
+  }
+  return result;
+}
+
+bool Topology::ParseAffinity(const std::string &text, Affinity &mode,
+                             bool &use_smt) {
+  auto colon = text.find(':');
+  std::string name = text.substr(0, colon);
+  std::string suffix = (colon == std::string::npos) ? "" : text.substr(colon);
+
+  if (suffix != "" && suffix != ":smt" && suffix != ":nosmt") {
+    return false;
+  }
+  if (name == "none") {
+    mode = Affinity::kNone;
+  } else if (name == "compact") {
+    mode = Affinity::kCompact;
+  } else if (name == "scatter") {
+    mode = Affinity::kScatter;
+  } else {
+    return false;
+  }
+  use_smt = suffix != ":nosmt";
+  return true;
+}
+
+bool PinCurrentThread(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace s21
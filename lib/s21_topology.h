@@ -0,0 +1,84 @@
+#ifndef PARALLELS_SRC_LIB_S21_TOPOLOGY_H_
+#define PARALLELS_SRC_LIB_S21_TOPOLOGY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace s21 {
+
+/// @brief placement of worker threads on logical CPUs
+enum class Affinity {
+  kNone,    // threads are not pinned, the scheduler decides
+  kCompact, // fill one package core by core before using the next one
+  kScatter  // spread threads round-robin over packages, then over cores
+};
+
+/// @brief logical CPU as described by /sys/devices/system/cpu/cpuN/topology
+struct CpuInfo {
+  int cpu = 0;
+  int package = 0;
+  int core = 0;
+  /// @brief index of this CPU among SMT siblings of its core (0 - first)
+  int smt = 0;
+};
+
+/// @brief sizes of data caches of one core in bytes (L3 is shared)
+struct CacheSizes {
+  std::size_t l1 = 32 << 10;
+  std::size_t l2 = 256 << 10;
+  std::size_t l3 = 8 << 20;
+};
+
+/// @brief topology of the machine (packages, cores, SMT siblings) restricted
+/// to CPUs allowed for the process. Read from /sys once; if it is not
+/// available every CPU is considered a separate core of one package and
+/// cache sizes keep their defaults.
+class Topology {
+public:
+  /// @brief topology of the current machine
+  static const Topology &Instance();
+
+  /// @brief builds topology from the list of CPUs (used for testing)
+  explicit Topology(std::vector<CpuInfo> cpus,
+                    CacheSizes caches = CacheSizes());
+
+  /// @brief CPUs available for the process
+  const std::vector<CpuInfo> &Cpus() const { return cpus_; }
+
+  /// @brief number of CPUs available for the process
+  std::size_t HardwareThreads() const { return cpus_.size(); }
+
+  /// @brief cache sizes of the first available CPU
+  const CacheSizes &Caches() const { return caches_; }
+
+  /// @brief returns ordered list of CPUs to pin threads on: thread i goes to
+  /// the CPU at position i % size
+  /// @param mode kCompact or kScatter (kNone returns all CPUs in order)
+  /// @param use_smt if false, only the first SMT sibling of every core is used
+  std::vector<int> Placement(Affinity mode, bool use_smt = true) const;
+
+  /// @brief parses affinity description: "none", "compact", "scatter",
+  /// optionally followed by ":nosmt"
+  /// @param text description
+  /// @param mode parsed mode
+  /// @param use_smt parsed SMT usage
+  /// @return false if text is not recognized
+  static bool ParseAffinity(const std::string &text, Affinity &mode,
+                            bool &use_smt);
+
+private:
+  std::vector<CpuInfo> cpus_;
+  CacheSizes caches_;
+
+  static std::vector<CpuInfo> ReadCpus();
+  static CacheSizes ReadCaches(int cpu);
+};
+
+/// @brief pins the calling thread to a single CPU
+/// @return false if pinning is not supported or failed
+bool PinCurrentThread(int cpu);
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_TOPOLOGY_H_
@@ -0,0 +1,159 @@
+#include "s21_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+struct Event {
+  const char *name;
+  std::int64_t start;
+  std::int64_t end;
+};
+
+/// @brief ring buffer of one thread. Only the owner writes events, the
+/// counter is published with release semantics for readers
+struct Buffer {
+  std::size_t tid = 0;
+  std::vector<Event> events;
+  std::atomic<std::size_t> written{0};
+};
+
+struct Registry {
+  std::mutex mtx;
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  /// @brief buffers of exited threads
+  std::vector<Buffer *> free;
+};
+
+Registry &GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+/// @brief buffer of the thread, returned to the registry on thread exit
+struct BufferOwner {
+  Buffer *buffer = nullptr;
+
+  ~BufferOwner() {
+    if (buffer != nullptr) {
+      Registry &registry = GetRegistry();
+      std::lock_guard<std::mutex> lock(registry.mtx);
+      registry.free.push_back(buffer);
+    }
+  }
+};
+
+thread_local BufferOwner tls_owner;
+
+Buffer &LocalBuffer() {
+  Buffer *&local = tls_owner.buffer;
+  if (local == nullptr) {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    if (!registry.free.empty()) {
+      // events of the exited thread stay and are exported under its tid
+      local = registry.free.back();
+      registry.free.pop_back();
+    } else {
+      auto buffer = std::make_shared<Buffer>();
+      buffer->events.resize(Trace::kBufferSize);
+      buffer->tid = registry.buffers.size() + 1;
+      registry.buffers.push_back(buffer);
+      local = buffer.get();
+    }
+  }
+  return *local;
+}
+
+} // namespace
+
+std::int64_t Trace::Now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+void Trace::Record(const char *name, std::int64_t start, std::int64_t end) {
+  Buffer &buffer = LocalBuffer();
+  std::size_t count = buffer.written.load(std::memory_order_relaxed);
+  buffer.events[count % kBufferSize] = {name, start, end};
+  buffer.written.store(count + 1, std::memory_order_release);
+}
+
+void Trace::Clear() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mtx);
+  for (auto &buffer : registry.buffers) {
+    buffer->written.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::size_t Trace::Size() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mtx);
+  std::size_t result = 0;
+  for (auto &buffer : registry.buffers) {
+    result += std::min(buffer->written.load(std::memory_order_acquire),
+                       kBufferSize);
+  }
+  return result;
+}
+
+std::size_t Trace::BufferCount() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mtx);
+  return registry.buffers.size();
+}
+
+void Trace::WriteChromeJson(std::ostream &out) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mtx);
+  auto flags = out.flags();
+  auto precision = out.precision();
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+
+  bool first = true;
+  for (auto &buffer : registry.buffers) {
+    std::size_t count = buffer->written.load(std::memory_order_acquire);
+    if (count == 0) {
+      continue;
+    }
+    out << (first ? "\n" : ",\n")
+        << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+        << buffer->tid << ", \"args\": {\"name\": \"thread " << buffer->tid
+        << "\"}}";
+    first = false;
+    std::size_t begin = (count > kBufferSize) ? count - kBufferSize : 0;
+    for (std::size_t i = begin; i < count; ++i) {
+      const Event &event = buffer->events[i % kBufferSize];
+      // timestamps are in microseconds
+      out << ",\n{\"name\": \"" << event.name
+          << "\", \"cat\": \"s21\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+          << buffer->tid << ", \"ts\": " << event.start / 1000.0
+          << ", \"dur\": " << (event.end - event.start) / 1000.0 << "}";
+    }
+  }
+  out << "\n], \"displayTimeUnit\": \"ns\"}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+bool Trace::Dump(const std::string &filename) {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    return false;
+  }
+  WriteChromeJson(file);
+  return static_cast<bool>(file);
+}
+
+} // namespace s21
@@ -0,0 +1,99 @@
+#ifndef PARALLELS_SRC_LIB_S21_TRACE_H_
+#define PARALLELS_SRC_LIB_S21_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace s21 {
+
+/// @brief lightweight tracing of algorithm phases. Every thread records
+/// complete events (name, start, duration) into its own ring buffer, so
+/// recording takes no locks; the oldest events are overwritten when the
+/// buffer is full. A buffer is handed to the next new thread when its
+/// thread exits, with the events kept, so short-lived threads do not add
+/// buffers. Tracing is off by default and costs one atomic load per
+/// scope then. Events are exported in Chrome trace format, which is opened
+/// by chrome://tracing and ui.perfetto.dev.
+class Trace {
+public:
+  /// @brief events kept per thread
+  static constexpr std::size_t kBufferSize = 1 << 16;
+
+  /// @brief turns recording on or off
+  static void Enable(bool enabled = true) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /// @brief true if events are recorded
+  static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /// @brief nanoseconds since the first call (monotonic clock)
+  static std::int64_t Now();
+
+  /// @brief records event of the calling thread
+  /// @param name name of phase, must be a string literal
+  /// @param start start time (see Now)
+  /// @param end end time (see Now)
+  static void Record(const char *name, std::int64_t start, std::int64_t end);
+
+  /// @brief drops events of all threads
+  static void Clear();
+
+  /// @brief number of events kept by all threads
+  static std::size_t Size();
+
+  /// @brief number of buffers, at most the number of threads that recorded
+  /// events at the same time
+  static std::size_t BufferCount();
+
+  /// @brief writes events in Chrome trace JSON format. Should be called when
+  /// traced computations are finished
+  /// @param out output stream
+  static void WriteChromeJson(std::ostream &out);
+
+  /// @brief writes events to file in Chrome trace JSON format
+  /// @param filename path to file
+  /// @return false if the file can not be written
+  static bool Dump(const std::string &filename);
+
+private:
+  inline static std::atomic<bool> enabled_{false};
+};
+
+/// @brief records event from construction to destruction when tracing is on
+class TraceScope {
+public:
+  explicit TraceScope(const char *name)
+      : name_(Trace::Enabled() ? name : nullptr),
+        start_(name_ ? Trace::Now() : 0) {}
+  TraceScope(const TraceScope &other) = delete;
+  TraceScope &operator=(const TraceScope &other) = delete;
+  ~TraceScope() {
+    if (name_) {
+      Trace::Record(name_, start_, Trace::Now());
+    }
+  }
+
+private:
+  const char *name_;
+  std::int64_t start_;
+};
+
+} // namespace s21
+
+#define S21_TRACE_CONCAT_IMPL(a, b) a##b
+#define S21_TRACE_CONCAT(a, b) S21_TRACE_CONCAT_IMPL(a, b)
+
+/// @brief traces the rest of the enclosing scope as phase "name". Compiled
+/// out when S21_DISABLE_TRACE is defined
+#ifdef S21_DISABLE_TRACE
+#define S21_TRACE_SCOPE(name)
+#else
+#define S21_TRACE_SCOPE(name)                                                  \
+  s21::TraceScope S21_TRACE_CONCAT(s21_trace_scope_, __LINE__)(name)
+#endif
+
+#endif // PARALLELS_SRC_LIB_S21_TRACE_H_
@@ -5,9 +5,11 @@
 #include <memory>
 #include <vector>
 
+#include "s21_matrix.h"
+
 namespace s21 {
 using row_type = std::vector<double>;
-using m_dbl_type = std::vector<row_type>;
+using m_dbl_type = Matrix<double>;
 using row_ptr = std::shared_ptr<row_type>;
 using m_ptr = std::shared_ptr<m_dbl_type>;
 using const_m_ptr = std::shared_ptr<const m_dbl_type>;
@@ -1,35 +1,72 @@
 #include "s21_vinograd_algorithms.h"
 
+#include <algorithm>
 #include <functional>
-#include <future>
 #include <memory>
 #include <mutex>
-#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
+
 namespace s21 {
 
-SimpleVinograd::SimpleVinograd(m_ptr first, m_ptr second, m_ptr result_ptr)
-    : first_(first), second_(second), result_(result_ptr) {
-  if (result_->size() != first_->size()) {
-    throw "";
-  }
+namespace {
+
+/// @brief type of intermediate sums: signed integers wrap around in the
+/// unsigned type, so products are exact while the result fits into T
+template <typename T, bool = std::is_integral_v<T>> struct SumType {
+  using type = T;
+};
+template <typename T> struct SumType<T, true> {
+  using type = std::make_unsigned_t<T>;
+};
+template <typename T> using sum_type = typename SumType<T>::type;
+
+template <typename T> constexpr bool kSimdKernels = std::is_same_v<T, double>;
 
-  for (auto &row : *result_) {
-    if (row.size() != second_->at(0).size()) {
-      throw "";
+/// @brief generic main loop, see VinogradKernels::main_row
+template <typename T>
+void MainRow(const T *a, const T *b, std::size_t stride, std::size_t pairs,
+             std::size_t cols, T row_factor, const T *col_factor, T *res) {
+  using S = sum_type<T>;
+  for (std::size_t j = 0; j < cols; ++j) {
+    res[j] = static_cast<T>(S(0) - S(row_factor) - S(col_factor[j]));
+  }
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const S a_even = S(a[2 * k]);
+    const S a_odd = S(a[2 * k + 1]);
+    const T *b_even = b + 2 * k * stride;
+    const T *b_odd = b_even + stride;
+    for (std::size_t j = 0; j < cols; ++j) {
+      res[j] = static_cast<T>(S(res[j]) + (a_even + S(b_odd[j])) *
+                                              (a_odd + S(b_even[j])));
     }
   }
+}
+
+} // namespace
 
-  f_rows_ = first_->size();
-  f_cols_ = first_->at(0).size();
-  s_rows_ = second_->size();
-  s_cols_ = second_->at(0).size();
-  row_factor_ = std::make_shared<row_type>(row_type(f_rows_, 0.0));
-  col_factor_ = std::make_shared<row_type>(row_type(s_cols_, 0.0));
+template <typename T>
+BasicSimpleVinograd<T>::BasicSimpleVinograd(const_matrix_ptr first,
+                                            const_matrix_ptr second,
+                                            matrix_ptr result_ptr)
+    : first_(first), second_(second), result_(result_ptr) {
+  if (result_->rows() != first_->rows() ||
+      result_->cols() != second_->cols()) {
+    throw "";
+  }
+
+  f_rows_ = first_->rows();
+  f_cols_ = first_->cols();
+  s_rows_ = second_->rows();
+  s_cols_ = second_->cols();
+  row_factor_ = std::make_shared<vector_type>(vector_type(f_rows_, T(0)));
+  col_factor_ = std::make_shared<vector_type>(vector_type(s_cols_, T(0)));
 }
 
-void SimpleVinograd::Multiply() {
+template <typename T> void BasicSimpleVinograd<T>::Multiply() {
   ComputeRowFactor();
   ComputeColFactor();
   MultiplyMainLoop(0, f_rows_);
@@ -38,117 +75,762 @@ void SimpleVinograd::Multiply() {
   }
 }
 
-void SimpleVinograd::ComputeRowFactor() {
-  std::fill(row_factor_->begin(), row_factor_->end(), 0.0);
+template <typename T> T BasicSimpleVinograd<T>::RowFactor(const T *row) const {
+  if constexpr (kSimdKernels<T>) {
+    return kernels_->row_factor(row, f_cols_ / 2);
+  } else {
+    sum_type<T> factor = 0;
+    for (size_t k = 0; k < f_cols_ / 2; ++k) {
+      factor += sum_type<T>(row[2 * k]) * sum_type<T>(row[2 * k + 1]);
+    }
+    return static_cast<T>(factor);
+  }
+}
 
-  for (size_t i = 0; i < f_rows_; ++i) {
-    for (size_t j = 0; j < f_cols_ / 2; ++j) {
-      row_factor_->at(i) +=
-          first_->at(i).at(2 * j) * first_->at(i).at(2 * j + 1);
+template <typename T>
+void BasicSimpleVinograd<T>::AddColFactor(const T *even, const T *odd,
+                                          size_t cols, T *factor) const {
+  if constexpr (kSimdKernels<T>) {
+    kernels_->col_factor(even, odd, cols, factor);
+  } else {
+    using S = sum_type<T>;
+    for (size_t j = 0; j < cols; ++j) {
+      factor[j] = static_cast<T>(S(factor[j]) + S(even[j]) * S(odd[j]));
     }
   }
 }
 
-void SimpleVinograd::ComputeColFactor() {
-  std::fill(col_factor_->begin(), col_factor_->end(), 0.0);
+template <typename T> void BasicSimpleVinograd<T>::ComputeRowFactor() {
+  S21_TRACE_SCOPE("ComputeRowFactor");
+  const matrix_type &first = *first_;
+  vector_type &row_factor = *row_factor_;
 
-  for (size_t i = 0; i < s_cols_; ++i) {
-    for (size_t j = 0; j < f_cols_ / 2; ++j) {
-      col_factor_->at(i) +=
-          second_->at(2 * j).at(i) * second_->at(2 * j + 1).at(i);
-    }
+  for (size_t i = 0; i < f_rows_; ++i) {
+    row_factor[i] = RowFactor(first[i]);
   }
 }
 
-void SimpleVinograd::AddBiasForOddRows(size_t start, size_t end) {
+template <typename T> void BasicSimpleVinograd<T>::ComputeColFactor() {
+  S21_TRACE_SCOPE("ComputeColFactor");
+  std::fill(col_factor_->begin(), col_factor_->end(), T(0));
+  const matrix_type &second = *second_;
+  vector_type &col_factor = *col_factor_;
+
+  for (size_t j = 0; j < f_cols_ / 2; ++j) {
+    AddColFactor(second[2 * j], second[2 * j + 1], s_cols_,
+                 col_factor.data());
+  }
+}
+
+template <typename T>
+void BasicSimpleVinograd<T>::AddBiasForOddRows(size_t start, size_t end) {
+  AddBiasForOddRows(start, end, 0, s_cols_);
+}
+
+template <typename T>
+void BasicSimpleVinograd<T>::AddBiasForOddRows(size_t start, size_t end,
+                                               size_t col, size_t cols) {
+  S21_TRACE_SCOPE("AddBiasForOddRows");
+  using S = sum_type<T>;
+  const matrix_type &first = *first_;
+  const T *last = (*second_)[f_cols_ - 1] + col;
+
   for (size_t i = start; i < end; ++i) {
-    for (size_t j = 0; j < s_cols_; ++j) {
-      result_->at(i).at(j) +=
-          first_->at(i).at(f_cols_ - 1) * second_->at(f_cols_ - 1).at(j);
+    T *res = (*result_)[i] + col;
+    const S bias = S(first(i, f_cols_ - 1));
+    for (size_t j = 0; j < cols; ++j) {
+      res[j] = static_cast<T>(S(res[j]) + bias * S(last[j]));
     }
   }
 }
 
-void SimpleVinograd::MultiplyMainLoop(size_t start, size_t end) {
+template <typename T>
+void BasicSimpleVinograd<T>::MultiplyMainLoop(size_t start, size_t end) {
+  MultiplyMainLoop(start, end, 0, s_cols_);
+}
+
+template <typename T>
+void BasicSimpleVinograd<T>::MultiplyMainLoop(size_t start, size_t end,
+                                              size_t col, size_t cols) {
+  S21_TRACE_SCOPE("MultiplyMainLoop");
+  const matrix_type &second = *second_;
+  const vector_type &row_factor = *row_factor_;
+  const vector_type &col_factor = *col_factor_;
+
   for (size_t i = start; i < end; ++i) {
-    for (size_t j = 0; j < s_cols_; ++j) {
-      result_->at(i).at(j) = -row_factor_->at(i) - col_factor_->at(j);
+    if constexpr (kSimdKernels<T>) {
+      kernels_->main_row((*first_)[i], second.data() + col, second.stride(),
+                         f_cols_ / 2, cols, row_factor[i],
+                         col_factor.data() + col, (*result_)[i] + col);
+    } else {
+      MainRow((*first_)[i], second.data() + col, second.stride(),
+              f_cols_ / 2, cols, row_factor[i], col_factor.data() + col,
+              (*result_)[i] + col);
+    }
+  }
+}
 
-      for (size_t k = 0; k < f_cols_ / 2; ++k) {
-        result_->at(i).at(j) +=
-            (first_->at(i).at(2 * k) + second_->at(2 * k + 1).at(j)) *
-            (first_->at(i).at(2 * k + 1) + second_->at(2 * k).at(j));
-      }
+template <typename T>
+template <bool kOdd>
+void BasicSimpleVinograd<T>::MultiplyRange(size_t start, size_t end,
+                                           size_t col, size_t cols) {
+  MultiplyMainLoop(start, end, col, cols);
+  if constexpr (kOdd) {
+    AddBiasForOddRows(start, end, col, cols);
+  }
+}
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+BasicParallelVinograd<T>::BasicParallelVinograd(const_matrix_ptr first,
+                                                const_matrix_ptr second,
+                                                matrix_ptr result,
+                                                std::size_t t_num,
+                                                std::size_t tile_rows,
+                                                std::size_t tile_cols)
+    : BasicSimpleVinograd<T>(first, second, result),
+      threads_num_(std::max<std::size_t>(t_num, 1)), tile_rows_(tile_rows),
+      tile_cols_(tile_cols) {
+  const std::size_t rows = std::max<std::size_t>(f_rows_, 1);
+  const std::size_t cols = std::max<std::size_t>(s_cols_, 1);
+  const std::size_t target = threads_num_ * kTilesPerThread;
+  if (tile_rows_ == 0) {
+    tile_rows_ = (rows + target - 1) / target;
+  }
+  tile_rows_ = std::min(tile_rows_, rows);
+  row_tiles_ = (rows + tile_rows_ - 1) / tile_rows_;
+  if (tile_cols_ == 0) {
+    // rows alone give too few tiles for short results: split columns too,
+    // in whole micro-panels so that vector kernels keep full width
+    const std::size_t col_tiles = (target + row_tiles_ - 1) / row_tiles_;
+    tile_cols_ = (cols + col_tiles - 1) / col_tiles;
+    tile_cols_ = (tile_cols_ + kVinogradMicroCols - 1) / kVinogradMicroCols *
+                 kVinogradMicroCols;
+  }
+  tile_cols_ = std::min(tile_cols_, cols);
+  col_tiles_ = (cols + tile_cols_ - 1) / tile_cols_;
+}
+
+template <typename T> void BasicParallelVinograd<T>::Multiply() {
+  ComputeFactors();
+  next_tile_ = 0;
+  const bool odd = f_cols_ % 2 != 0;
+  auto worker = [this, odd]() {
+    odd ? MultiplyTiles<true>() : MultiplyTiles<false>();
+  };
+  const std::size_t tasks = std::min(threads_num_, row_tiles_ * col_tiles_);
+  TaskGroup group;
+  for (std::size_t i = 1; i < tasks; ++i) {
+    group.Run(worker);
+  }
+  worker();
+  group.Wait();
+}
+
+template <typename T> void BasicParallelVinograd<T>::ComputeFactors() {
+  const Matrix<T> &first = *first_;
+  const Matrix<T> &second = *second_;
+  std::vector<T> &row_factor = *row_factor_;
+  std::vector<T> &col_factor = *col_factor_;
+  const std::size_t pairs = f_cols_ / 2;
+
+  ParallelFor(0, f_rows_, threads_num_, [&](std::size_t start,
+                                            std::size_t end) {
+    S21_TRACE_SCOPE("ComputeRowFactor");
+    for (std::size_t i = start; i < end; ++i) {
+      row_factor[i] = this->RowFactor(first[i]);
+    }
+  });
+  // every thread sums all pairs over its own columns, so no reduction
+  ParallelFor(0, s_cols_, threads_num_, [&](std::size_t start,
+                                            std::size_t end) {
+    S21_TRACE_SCOPE("ComputeColFactor");
+    T *factor = col_factor.data() + start;
+    std::fill(factor, factor + (end - start), T(0));
+    for (std::size_t k = 0; k < pairs; ++k) {
+      this->AddColFactor(second[2 * k] + start, second[2 * k + 1] + start,
+                         end - start, factor);
     }
+  });
+}
+
+template <typename T>
+template <bool kOdd>
+void BasicParallelVinograd<T>::MultiplyTiles() {
+  const std::size_t tiles = row_tiles_ * col_tiles_;
+  for (std::size_t tile = next_tile_++; tile < tiles; tile = next_tile_++) {
+    // neighbouring tiles share rows of the first matrix
+    const std::size_t start = tile / col_tiles_ * tile_rows_;
+    const std::size_t end = std::min(start + tile_rows_, f_rows_);
+    const std::size_t col = tile % col_tiles_ * tile_cols_;
+    const std::size_t cols = std::min(tile_cols_, s_cols_ - col);
+    this->template MultiplyRange<kOdd>(start, end, col, cols);
   }
 }
 /////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+BasicPipeVinograd<T>::BasicPipeVinograd(const_matrix_ptr first,
+                                        const_matrix_ptr second,
+                                        matrix_ptr result, std::size_t t_num)
+    : BasicSimpleVinograd<T>(first, second, result),
+      threads_num_(std::max<std::size_t>(t_num, 1)) {
+  const std::size_t bands = threads_num_ * kBandsPerThread;
+  band_rows_ = std::max<std::size_t>((f_rows_ + bands - 1) / bands, 1);
+}
 
-void ParallelVinograd::Multiply() {
-  std::vector<std::thread> thread_vector;
-  auto step = f_rows_ / threads_num_;
-  auto start = 0;
-  auto end = step;
+template <typename T> void BasicPipeVinograd<T>::Multiply() {
+  Bands bands(kQueueDepth);
+  if (f_cols_ % 2 != 0) {
+    ProduceBands<true>(bands);
+  } else {
+    ProduceBands<false>(bands);
+  }
+}
+
+template <typename T>
+template <bool kOdd>
+void BasicPipeVinograd<T>::ProduceBands(Bands &bands) {
+  // column factors overlap with the first row bands
+  TaskGroup factors;
+  factors.Run([this]() { this->ComputeColFactor(); });
 
-  for (std::size_t i = 0; i < threads_num_; ++i) {
-    if (i == (threads_num_ - 1)) {
-      end += (f_rows_ % threads_num_);
+  // consumers start when the column factors are ready; they wait for bands
+  // only while the calling thread produces them, so they always progress
+  TaskGroup consumers;
+  bool started = false;
+  auto start_consumers = [&]() {
+    {
+      S21_TRACE_SCOPE("WaitFactors");
+      factors.Wait();
+    }
+    const std::size_t count =
+        std::min(threads_num_, (f_rows_ + band_rows_ - 1) / band_rows_);
+    for (std::size_t i = 1; i < count; ++i) {
+      consumers.Run([this, &bands]() { ConsumeBands<kOdd>(bands); });
     }
+    started = true;
+  };
 
-    thread_vector.push_back(
-        std::thread(&ParallelVinograd::MultiplyPartial, this, start, end));
-    start += step;
-    end += step;
+  const Matrix<T> &first = *first_;
+  std::vector<T> &row_factor = *row_factor_;
+  try {
+    for (size_t start = 0; start < f_rows_; start += band_rows_) {
+      std::pair<size_t, size_t> band(start,
+                                     std::min(start + band_rows_, f_rows_));
+      {
+        S21_TRACE_SCOPE("ComputeRowFactor");
+        for (size_t i = band.first; i < band.second; ++i) {
+          row_factor[i] = this->RowFactor(first[i]);
+        }
+      }
+      while (!bands.TryPush(band)) {
+        // the queue is full: start the consumers or take a band of them
+        std::pair<size_t, size_t> ready;
+        if (!started) {
+          start_consumers();
+        } else if (bands.TryPop(ready)) {
+          this->template MultiplyRange<kOdd>(ready.first, ready.second, 0,
+                                             s_cols_);
+        }
+      }
+    }
+    if (!started) {
+      start_consumers();
+    }
+  } catch (...) {
+    bands.Close();
+    throw;
   }
+  bands.Close();
+  ConsumeBands<kOdd>(bands);
+  consumers.Wait();
+}
 
-  for (auto &threaD : thread_vector) {
-    threaD.join();
+template <typename T>
+template <bool kOdd>
+void BasicPipeVinograd<T>::ConsumeBands(Bands &bands) {
+  std::pair<size_t, size_t> band;
+  while (bands.Pop(band)) {
+    this->template MultiplyRange<kOdd>(band.first, band.second, 0, s_cols_);
   }
 }
 
-void ParallelVinograd::MultiplyPartial(size_t start, size_t end) {
-  std::call_once(flag_one_, [this]() { SimpleVinograd::ComputeRowFactor(); });
-  std::call_once(flag_two_, [this]() { SimpleVinograd::ComputeColFactor(); });
-  MultiplyMainLoop(start, end);
-  if (f_cols_ % 2 != 0) {
-    AddBiasForOddRows(start, end);
+template class BasicSimpleVinograd<float>;
+template class BasicSimpleVinograd<double>;
+template class BasicSimpleVinograd<std::int64_t>;
+template class BasicPipeVinograd<float>;
+template class BasicPipeVinograd<double>;
+template class BasicPipeVinograd<std::int64_t>;
+template class BasicParallelVinograd<float>;
+template class BasicParallelVinograd<double>;
+template class BasicParallelVinograd<std::int64_t>;
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void IncrementalVinograd::Multiply() {
+  SimpleVinograd::Multiply();
+  factors_ready_ = true;
+}
+
+void IncrementalVinograd::Update(const std::vector<std::size_t> &rows,
+                                 const std::vector<std::size_t> &cols) {
+  S21_TRACE_SCOPE("IncrementalUpdate");
+  if (!factors_ready_) {
+    ComputeRowFactor();
+    ComputeColFactor();
+    factors_ready_ = true;
+  } else {
+    const m_dbl_type &first = *first_;
+    const m_dbl_type &second = *second_;
+    row_type &row_factor = *row_factor_;
+    row_type &col_factor = *col_factor_;
+    for (std::size_t i : rows) {
+      row_factor[i] = kernels_->row_factor(first[i], f_cols_ / 2);
+    }
+    for (std::size_t j : cols) {
+      double factor = 0.0;
+      for (std::size_t k = 0; k < f_cols_ / 2; ++k) {
+        factor += second(2 * k, j) * second(2 * k + 1, j);
+      }
+      col_factor[j] = factor;
+    }
+  }
+
+  ParallelFor(0, rows.size(), threads_num_,
+              [this, &rows](std::size_t start, std::size_t end) {
+                for (std::size_t r = start; r < end; ++r) {
+                  MultiplyMainLoop(rows[r], rows[r] + 1);
+                  if (f_cols_ % 2 != 0) {
+                    AddBiasForOddRows(rows[r], rows[r] + 1);
+                  }
+                }
+              });
+  if (cols.empty()) {
+    return;
+  }
+  // changed rows are already complete, the other ones get changed columns
+  std::vector<bool> done(f_rows_, false);
+  for (std::size_t i : rows) {
+    done[i] = true;
   }
+  ParallelFor(0, f_rows_, threads_num_,
+              [this, &cols, &done](std::size_t start, std::size_t end) {
+                for (std::size_t i = start; i < end; ++i) {
+                  if (done[i]) {
+                    continue;
+                  }
+                  for (std::size_t j : cols) {
+                    MultiplyMainLoop(i, i + 1, j, 1);
+                    if (f_cols_ % 2 != 0) {
+                      AddBiasForOddRows(i, i + 1, j, 1);
+                    }
+                  }
+                }
+              });
 }
 /////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////
-void PipeVinograd::Multiply() {
-  std::packaged_task<void()> task(
-      [this]() mutable { SimpleVinograd::ComputeRowFactor(); });
-  future_one_ = task.get_future();
-  std::thread th_one(std::move(task));
-
-  std::packaged_task<void()> second_task(
-      [&]() mutable { SimpleVinograd::ComputeColFactor(); });
-  future_two_ = second_task.get_future();
-  std::thread th_two(std::move(second_task));
-
-  std::thread th_three(&PipeVinograd::MultiplyPartialMatrix, this, 0, f_rows_);
-
-  th_one.join();
-  th_two.join();
-  th_three.join();
+
+BlockedVinograd::BlockedVinograd(const_m_ptr first, const_m_ptr second,
+                                 m_ptr result, Tiles tiles)
+    : SimpleVinograd(first, second, result),
+      tiles_(AdjustTiles(tiles, Topology::Instance().Caches())) {}
+
+BlockedVinograd::Tiles BlockedVinograd::AdjustTiles(Tiles tiles,
+                                                    const CacheSizes &caches) {
+  // bytes taken by one pair of rows in a micro-panel
+  const std::size_t pair_bytes = 2 * kMicroCols * sizeof(double);
+  if (tiles.pairs == 0) {
+    // a micro-panel takes half of L1, the rest is for rows of first matrix
+    tiles.pairs = std::clamp<std::size_t>(caches.l1 / 2 / pair_bytes, 16, 1024);
+  }
+  if (tiles.rows == 0) {
+    // a block of rows of the first matrix takes half of L2
+    tiles.rows = std::clamp<std::size_t>(
+        caches.l2 / 2 / (2 * tiles.pairs * sizeof(double)), 1, 4096);
+  }
+  if (tiles.cols == 0) {
+    // the packed block of the second matrix takes half of L3
+    tiles.cols = std::clamp<std::size_t>(
+        caches.l3 / 2 / (tiles.pairs * pair_bytes) * kMicroCols, 1, 8192);
+  }
+  tiles.rows = std::max(kMicroRows, tiles.rows / kMicroRows * kMicroRows);
+  tiles.cols = std::max(kMicroCols, tiles.cols / kMicroCols * kMicroCols);
+  return tiles;
+}
+
+void BlockedVinograd::Multiply() {
+  ComputeRowFactor();
+  ComputeColFactor();
+  const std::size_t pairs = f_cols_ / 2;
+  if (pairs == 0) {
+    MultiplyMainLoop(0, f_rows_);
+  }
+
+  std::size_t panels = (std::min(tiles_.cols, s_cols_) + kMicroCols - 1) /
+                       kMicroCols;
+  std::size_t panel_size = 2 * kMicroCols * std::min(tiles_.pairs, pairs);
+  if (packed_.rows() < panels || packed_.cols() < panel_size) {
+    packed_ = m_dbl_type(panels, panel_size);
+  }
+
+  for (std::size_t col = 0; col < s_cols_; col += tiles_.cols) {
+    std::size_t cols = std::min(tiles_.cols, s_cols_ - col);
+    for (std::size_t pair = 0; pair < pairs; pair += tiles_.pairs) {
+      std::size_t block_pairs = std::min(tiles_.pairs, pairs - pair);
+      PackBlock(col, cols, pair, block_pairs);
+      for (std::size_t row = 0; row < f_rows_; row += tiles_.rows) {
+        std::size_t rows = std::min(tiles_.rows, f_rows_ - row);
+        MultiplyBlock(row, rows, col, cols, pair, block_pairs);
+      }
+    }
+  }
+
   if (f_cols_ % 2 != 0) {
-    auto thread_four =
-        std::thread(&SimpleVinograd::AddBiasForOddRows, this, 0, f_rows_);
-    thread_four.join();
+    AddBiasForOddRows(0, f_rows_);
   }
 }
 
-void PipeVinograd::MultiplyPartialMatrix(size_t start, size_t end) {
-  future_one_.wait();
-  future_two_.wait();
-  {
-    std::lock_guard<std::mutex> vino_lock(mtx_a_);
-    MultiplyMainLoop(start, end);
+void BlockedVinograd::PackBlock(std::size_t col, std::size_t cols,
+                                std::size_t pair, std::size_t pairs) {
+  S21_TRACE_SCOPE("PackBlock");
+  const m_dbl_type &second = *second_;
+  for (std::size_t j = 0; j < cols; j += kMicroCols) {
+    double *panel = packed_[j / kMicroCols];
+    std::size_t width = std::min(kMicroCols, cols - j);
+    for (std::size_t k = 0; k < pairs; ++k) {
+      double *odd = panel + 2 * kMicroCols * k;
+      double *even = odd + kMicroCols;
+      std::copy_n(second[2 * (pair + k) + 1] + col + j, width, odd);
+      std::copy_n(second[2 * (pair + k)] + col + j, width, even);
+      std::fill(odd + width, odd + kMicroCols, 0.0);
+      std::fill(even + width, even + kMicroCols, 0.0);
+    }
   }
 }
+
+void BlockedVinograd::MultiplyBlock(std::size_t row, std::size_t rows,
+                                    std::size_t col, std::size_t cols,
+                                    std::size_t pair, std::size_t pairs) {
+  S21_TRACE_SCOPE("MultiplyBlock");
+  for (std::size_t j = 0; j < cols; j += kMicroCols) {
+    const double *panel = packed_[j / kMicroCols];
+    std::size_t width = std::min(kMicroCols, cols - j);
+    for (std::size_t i = 0; i < rows; i += kMicroRows) {
+      MultiplyMicroTile(row + i, std::min(kMicroRows, rows - i), col + j,
+                        width, pair, pairs, panel);
+    }
+  }
+}
+
+void BlockedVinograd::MultiplyMicroTile(std::size_t row, std::size_t rows,
+                                        std::size_t col, std::size_t cols,
+                                        std::size_t pair, std::size_t pairs,
+                                        const double *panel) {
+  double acc[kMicroRows][kMicroCols];
+  // kernels read all kMicroRows rows, missing ones repeat the first row
+  const double *a[kMicroRows];
+  for (std::size_t r = 0; r < kMicroRows; ++r) {
+    a[r] = (*first_)[row + (r < rows ? r : 0)] + 2 * pair;
+  }
+  kernels_->micro_tile(a, panel, pairs, acc[0]);
+
+  const row_type &row_factor = *row_factor_;
+  const row_type &col_factor = *col_factor_;
+  for (std::size_t r = 0; r < rows; ++r) {
+    double *res = (*result_)[row + r] + col;
+    if (pair == 0) {
+      for (std::size_t c = 0; c < cols; ++c) {
+        res[c] = acc[r][c] - row_factor[row + r] - col_factor[col + c];
+      }
+    } else {
+      for (std::size_t c = 0; c < cols; ++c) {
+        res[c] += acc[r][c];
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////
 
+StrassenVinograd::StrassenVinograd(const_m_ptr first, const_m_ptr second,
+                                   m_ptr result, std::size_t cutoff,
+                                   std::size_t t_num)
+    : SimpleVinograd(first, second, result),
+      cutoff_(std::max<std::size_t>(cutoff, 1)),
+      threads_num_(std::max<std::size_t>(t_num, 1)) {
+  const std::size_t smallest = std::min({f_rows_, f_cols_, s_cols_});
+  while (smallest > 0 && ((smallest - 1) >> depth_) + 1 > cutoff_) {
+    ++depth_;
+  }
+  if (depth_ == 0) {
+    blocked_ = std::make_unique<BlockedVinograd>(first, second, result);
+    return;
+  }
+  for (std::size_t tasks = 1; tasks < threads_num_ && parallel_depth_ < depth_;
+       tasks *= 7) {
+    ++parallel_depth_;
+  }
+
+  auto round_up = [](std::size_t size, std::size_t step) {
+    return (size + step - 1) / step * step;
+  };
+  const std::size_t rows = round_up(f_rows_, std::size_t(1) << depth_);
+  const std::size_t inner = round_up(f_cols_, std::size_t(2) << depth_);
+  const std::size_t cols = round_up(s_cols_, std::size_t(1) << depth_);
+  if (rows != f_rows_ || inner != f_cols_) {
+    padded_first_ = m_dbl_type(rows, inner);
+  }
+  if (inner != f_cols_ || cols != s_cols_) {
+    padded_second_ = m_dbl_type(inner, cols);
+  }
+  if (rows != f_rows_ || cols != s_cols_) {
+    padded_result_ = m_dbl_type(rows, cols);
+  }
+  scratch_.resize(ScratchSize(rows, inner, cols, 0));
+}
+
+std::size_t StrassenVinograd::ScratchSize(std::size_t rows, std::size_t inner,
+                                          std::size_t cols,
+                                          std::size_t level) const {
+  if (level == depth_) {
+    // factors of columns and rows, micro-panels of the packed second matrix
+    const std::size_t panels = (cols + kVinogradMicroCols - 1) /
+                               kVinogradMicroCols;
+    return cols + rows + panels * kVinogradMicroCols * inner;
+  }
+  rows /= 2;
+  inner /= 2;
+  cols /= 2;
+  std::size_t child = ScratchSize(rows, inner, cols, level + 1);
+  if (level < parallel_depth_) {
+    // S1..S4, T1..T4, three products and a subtree per product
+    return 4 * rows * inner + 4 * inner * cols + 3 * rows * cols + 7 * child;
+  }
+  // X, Y, Z of the sequential schedule, subtrees reuse the same memory
+  return rows * inner + inner * cols + rows * cols + child;
+}
+
+void StrassenVinograd::Multiply() {
+  if (depth_ == 0) {
+    blocked_->SetKernels(*kernels_);
+    blocked_->Multiply();
+    return;
+  }
+
+  const_view a = first_->View();
+  const_view b = second_->View();
+  view c = result_->View();
+  {
+    S21_TRACE_SCOPE("PadOperands");
+    if (!padded_first_.empty()) {
+      for (std::size_t i = 0; i < f_rows_; ++i) {
+        std::copy_n((*first_)[i], f_cols_, padded_first_[i]);
+      }
+      a = padded_first_.View();
+    }
+    if (!padded_second_.empty()) {
+      for (std::size_t i = 0; i < s_rows_; ++i) {
+        std::copy_n((*second_)[i], s_cols_, padded_second_[i]);
+      }
+      b = padded_second_.View();
+    }
+    if (!padded_result_.empty()) {
+      c = padded_result_.View();
+    }
+  }
+
+  MultiplyRecursive(a, b, c, 0, scratch_.data());
+
+  if (!padded_result_.empty()) {
+    for (std::size_t i = 0; i < f_rows_; ++i) {
+      std::copy_n(padded_result_[i], s_cols_, (*result_)[i]);
+    }
+  }
+}
+
+void StrassenVinograd::MultiplyRecursive(const_view a, const_view b, view c,
+                                         std::size_t level, double *scratch) {
+  if (level == depth_) {
+    MultiplyLeaf(a, b, c, scratch);
+  } else if (level < parallel_depth_) {
+    MultiplyParallel(a, b, c, level, scratch);
+  } else {
+    MultiplySequential(a, b, c, level, scratch);
+  }
+}
+
+void StrassenVinograd::MultiplySequential(const_view a, const_view b, view c,
+                                          std::size_t level, double *scratch) {
+  const std::size_t m = a.rows() / 2, k = a.cols() / 2, n = b.cols() / 2;
+  const_view a11 = a.Block(0, 0, m, k), a12 = a.Block(0, k, m, k);
+  const_view a21 = a.Block(m, 0, m, k), a22 = a.Block(m, k, m, k);
+  const_view b11 = b.Block(0, 0, k, n), b12 = b.Block(0, n, k, n);
+  const_view b21 = b.Block(k, 0, k, n), b22 = b.Block(k, n, k, n);
+  view c11 = c.Block(0, 0, m, n), c12 = c.Block(0, n, m, n);
+  view c21 = c.Block(m, 0, m, n), c22 = c.Block(m, n, m, n);
+
+  view x(scratch, m, k, k);
+  view y(x.data() + m * k, k, n, n);
+  view z(y.data() + k * n, m, n, n);
+  double *rest = z.data() + m * n;
+  const std::size_t next = level + 1;
+
+  // schedule of Douglas et al.: three temporaries, products land in c
+  Add(a11, a21, x, -1.0, level);                // S3
+  Add(b22, b12, y, -1.0, level);                // T3
+  MultiplyRecursive(x, y, c21, next, rest);     // P7
+  Add(a21, a22, x, 1.0, level);                 // S1
+  Add(b12, b11, y, -1.0, level);                // T1
+  MultiplyRecursive(x, y, c22, next, rest);     // P5
+  Add(x, a11, x, -1.0, level);                  // S2
+  Add(b22, y, y, -1.0, level);                  // T2
+  MultiplyRecursive(x, y, c12, next, rest);     // P6
+  Add(a12, x, x, -1.0, level);                  // S4
+  MultiplyRecursive(x, b22, c11, next, rest);   // P3
+  MultiplyRecursive(a11, b11, z, next, rest);   // P1
+  Add(z, c12, c12, 1.0, level);                 // U2 = P1 + P6
+  Add(c12, c21, c21, 1.0, level);               // U3 = U2 + P7
+  Add(c12, c22, c12, 1.0, level);               // U4 = U2 + P5
+  Add(c21, c22, c22, 1.0, level);               // U7 = U3 + P5
+  Add(c12, c11, c12, 1.0, level);               // U5 = U4 + P3
+  Add(y, b21, y, -1.0, level);                  // T4
+  MultiplyRecursive(a22, y, c11, next, rest);   // P4
+  Add(c21, c11, c21, -1.0, level);              // U6 = U3 - P4
+  MultiplyRecursive(a12, b21, c11, next, rest); // P2
+  Add(z, c11, c11, 1.0, level);                 // U1 = P1 + P2
+}
+
+void StrassenVinograd::MultiplyParallel(const_view a, const_view b, view c,
+                                        std::size_t level, double *scratch) {
+  const std::size_t m = a.rows() / 2, k = a.cols() / 2, n = b.cols() / 2;
+  const_view a11 = a.Block(0, 0, m, k), a12 = a.Block(0, k, m, k);
+  const_view a21 = a.Block(m, 0, m, k), a22 = a.Block(m, k, m, k);
+  const_view b11 = b.Block(0, 0, k, n), b12 = b.Block(0, n, k, n);
+  const_view b21 = b.Block(k, 0, k, n), b22 = b.Block(k, n, k, n);
+  view c11 = c.Block(0, 0, m, n), c12 = c.Block(0, n, m, n);
+  view c21 = c.Block(m, 0, m, n), c22 = c.Block(m, n, m, n);
+
+  auto take = [&scratch](std::size_t rows, std::size_t cols) {
+    view result(scratch, rows, cols, cols);
+    scratch += rows * cols;
+    return result;
+  };
+  view s1 = take(m, k), s2 = take(m, k), s3 = take(m, k), s4 = take(m, k);
+  view t1 = take(k, n), t2 = take(k, n), t3 = take(k, n), t4 = take(k, n);
+  view p1 = take(m, n), p2 = take(m, n), p4 = take(m, n);
+
+  Add(a21, a22, s1, 1.0, level);
+  Add(s1, a11, s2, -1.0, level);
+  Add(a11, a21, s3, -1.0, level);
+  Add(a12, s2, s4, -1.0, level);
+  Add(b12, b11, t1, -1.0, level);
+  Add(b22, t1, t2, -1.0, level);
+  Add(b22, b12, t3, -1.0, level);
+  Add(t2, b21, t4, -1.0, level);
+
+  struct Product {
+    const_view a;
+    const_view b;
+    view c;
+  };
+  // P3, P5, P6 and P7 land in quadrants of c
+  const Product products[] = {{a11, b11, p1}, {a12, b21, p2}, {s4, b22, c11},
+                              {a22, t4, p4},  {s1, t1, c22},  {s2, t2, c12},
+                              {s3, t3, c21}};
+  const std::size_t child = ScratchSize(m, k, n, level + 1);
+  TaskGroup group;
+  for (std::size_t i = 1; i < 7; ++i) {
+    group.Run([this, &products, i, level, scratch, child]() {
+      MultiplyRecursive(products[i].a, products[i].b, products[i].c,
+                        level + 1, scratch + i * child);
+    });
+  }
+  MultiplyRecursive(products[0].a, products[0].b, products[0].c, level + 1,
+                    scratch);
+  group.Wait();
+
+  Add(p1, c12, c12, 1.0, level);  // U2 = P1 + P6
+  Add(c12, c21, c21, 1.0, level); // U3 = U2 + P7
+  Add(c12, c22, c12, 1.0, level); // U4 = U2 + P5
+  Add(c21, c22, c22, 1.0, level); // U7 = U3 + P5
+  Add(c12, c11, c12, 1.0, level); // U5 = U4 + P3
+  Add(c21, p4, c21, -1.0, level); // U6 = U3 - P4
+  Add(p1, p2, c11, 1.0, level);   // U1 = P1 + P2
+}
+
+void StrassenVinograd::MultiplyLeaf(const_view a, const_view b, view c,
+                                    double *scratch) {
+  S21_TRACE_SCOPE("MultiplyLeaf");
+  constexpr std::size_t kRows = kVinogradMicroRows;
+  constexpr std::size_t kCols = kVinogradMicroCols;
+  const std::size_t pairs = a.cols() / 2;
+  const std::size_t rows = c.rows();
+  const std::size_t cols = c.cols();
+  double *col_factor = scratch;
+  double *row_factor = col_factor + cols;
+  double *packed = row_factor + rows;
+
+  std::fill(col_factor, col_factor + cols, 0.0);
+  for (std::size_t k = 0; k < pairs; ++k) {
+    kernels_->col_factor(&b(2 * k, 0), &b(2 * k + 1, 0), cols, col_factor);
+  }
+  for (std::size_t i = 0; i < rows; ++i) {
+    row_factor[i] = kernels_->row_factor(&a(i, 0), pairs);
+  }
+
+  // the same micro-panels and micro-tiles as in BlockedVinograd: a leaf is
+  // small enough to be a single block
+  double acc[kRows * kCols];
+  const double *rows_a[kRows];
+  for (std::size_t j = 0; j < cols; j += kCols) {
+    const std::size_t width = std::min(kCols, cols - j);
+    double *panel = packed + j * a.cols();
+    for (std::size_t k = 0; k < pairs; ++k) {
+      double *odd = panel + 2 * kCols * k;
+      double *even = odd + kCols;
+      std::copy_n(&b(2 * k + 1, j), width, odd);
+      std::copy_n(&b(2 * k, j), width, even);
+      std::fill(odd + width, odd + kCols, 0.0);
+      std::fill(even + width, even + kCols, 0.0);
+    }
+    for (std::size_t i = 0; i < rows; i += kRows) {
+      const std::size_t height = std::min(kRows, rows - i);
+      for (std::size_t r = 0; r < kRows; ++r) {
+        rows_a[r] = &a(i + (r < height ? r : 0), 0);
+      }
+      kernels_->micro_tile(rows_a, panel, pairs, acc);
+      for (std::size_t r = 0; r < height; ++r) {
+        for (std::size_t col = 0; col < width; ++col) {
+          c(i + r, j + col) = acc[r * kCols + col] - row_factor[i + r] -
+                              col_factor[j + col];
+        }
+      }
+    }
+  }
+}
+
+void StrassenVinograd::Add(const_view x, const_view y, view z, double sign,
+                           std::size_t level) const {
+  auto add_rows = [&x, &y, &z, sign](std::size_t start, std::size_t end) {
+    for (std::size_t i = start; i < end; ++i) {
+      const double *first = &x(i, 0);
+      const double *second = &y(i, 0);
+      double *res = &z(i, 0);
+      for (std::size_t j = 0; j < z.cols(); ++j) {
+        res[j] = first[j] + sign * second[j];
+      }
+    }
+  };
+  // additions of parallel levels are split between threads too
+  if (level < parallel_depth_) {
+    ParallelFor(0, z.rows(), threads_num_, add_rows);
+  } else {
+    add_rows(0, z.rows());
+  }
+}
+
 } // namespace s21
@@ -1,33 +1,51 @@
 #ifndef PARALLELS_SRC_LIB_S21_VINOGRAD_ALGORITHMS_H_
 #define PARALLELS_SRC_LIB_S21_VINOGRAD_ALGORITHMS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <future>
 #include <memory>
-#include <mutex>
+#include <utility>
 #include <vector>
 
+#include "s21_bounded_queue.h"
+#include "s21_topology.h"
 #include "s21_types.h"
+#include "s21_vinograd_kernels.h"
 
 namespace s21 {
 
-class Vinograd {
+/// @brief Winograd engines are templates on the element type T. They are
+/// explicitly instantiated for float, double and std::int64_t; double
+/// engines use the SIMD kernels (see s21_vinograd_kernels.h), the other
+/// types use generic loops. Integer products are exact while the result
+/// fits into T: intermediate sums wrap around in the unsigned type.
+template <typename T> class BasicVinograd {
 public:
-  Vinograd() = default;
-  virtual ~Vinograd() = default;
+  BasicVinograd() = default;
+  virtual ~BasicVinograd() = default;
 
   /// @brief multiplies two matrices
   virtual void Multiply() = 0;
 
 };
 
-class SimpleVinograd : public Vinograd {
+template <typename T> class BasicSimpleVinograd : public BasicVinograd<T> {
 public:
+  using value_type = T;
+  using matrix_type = Matrix<T>;
+  using matrix_ptr = std::shared_ptr<Matrix<T>>;
+  using const_matrix_ptr = std::shared_ptr<const Matrix<T>>;
+  using vector_type = std::vector<T>;
+
   /// @brief ctor
   /// @param first first matrix
   /// @param second second matrix
   /// @param result result matrix.
-  SimpleVinograd(m_ptr first, m_ptr second, m_ptr result);
-  ~SimpleVinograd() = default;
+  BasicSimpleVinograd(const_matrix_ptr first, const_matrix_ptr second,
+                      matrix_ptr result);
+  ~BasicSimpleVinograd() = default;
 
   /// @brief multiplies two matrices
   void Multiply() override;
@@ -36,66 +54,311 @@ public:
   /// @param start start row
   /// @param end end row
   void AddBiasForOddRows(size_t start, size_t end);
+  /// @brief the same for columns [col, col + cols) of the rows only
+  void AddBiasForOddRows(size_t start, size_t end, size_t col, size_t cols);
+  /// @brief replaces inner loops of double engines, e.g. to compare
+  /// instruction sets
+  /// @param kernels kernels supported by the CPU
+  void SetKernels(const VinogradKernels &kernels) { kernels_ = &kernels; }
+  /// @brief inner loops in use
+  const VinogradKernels &GetKernels() const { return *kernels_; }
 
 protected:
-  const_m_ptr first_;
-  const_m_ptr second_;
-  m_ptr result_;
+  const_matrix_ptr first_;
+  const_matrix_ptr second_;
+  matrix_ptr result_;
   std::size_t f_rows_;
   std::size_t f_cols_;
   std::size_t s_rows_;
   std::size_t s_cols_;
-  std::shared_ptr<std::vector<double>> row_factor_;
-  std::shared_ptr<std::vector<double>> col_factor_;
+  std::shared_ptr<vector_type> row_factor_;
+  std::shared_ptr<vector_type> col_factor_;
+  const VinogradKernels *kernels_ = &DefaultVinogradKernels();
 
   void ComputeRowFactor();
   void ComputeColFactor();
   void MultiplyMainLoop(size_t, size_t);
+  /// @brief main loop over columns [col, col + cols) of rows [start, end)
+  void MultiplyMainLoop(size_t start, size_t end, size_t col, size_t cols);
+  /// @brief main loop and, for odd inner dimension (kOdd), the bias over a
+  /// block of the result. Engines choose the instantiation once per
+  /// Multiply, so the even one has no trace of the bias
+  template <bool kOdd>
+  void MultiplyRange(size_t start, size_t end, size_t col, size_t cols);
+
+  /// @brief sum of row[2k] * row[2k + 1]
+  T RowFactor(const T *row) const;
+  /// @brief factor[j] += even[j] * odd[j] for j < cols
+  void AddColFactor(const T *even, const T *odd, size_t cols,
+                    T *factor) const;
 };
 
-class PipeVinograd : public SimpleVinograd {
+/// @brief pipelined Winograd multiplication of one pair. The rows are split
+/// into bands: the calling thread computes row factors band by band and
+/// passes ready bands through a bounded queue to the main loop stage, which
+/// runs on t_num - 1 tasks of the pool. When the queue is full the calling
+/// thread multiplies a band itself instead of waiting. Column factors are
+/// computed by a pool task meanwhile. No threads are created per call. See
+/// VinogradPipeline for streams of pairs.
+template <typename T>
+class BasicPipeVinograd : public BasicSimpleVinograd<T> {
 public:
+  using typename BasicSimpleVinograd<T>::matrix_ptr;
+  using typename BasicSimpleVinograd<T>::const_matrix_ptr;
+
+  /// @brief bands per thread of the main loop
+  static constexpr std::size_t kBandsPerThread = 4;
+  /// @brief ready bands waiting for the main loop
+  static constexpr std::size_t kQueueDepth = 4;
+
   /// @brief ctor
   /// @param first first matrix for multiplication
   /// @param second second matrix for multiplication
   /// @param result result matrix
-  PipeVinograd(m_ptr first, m_ptr second, m_ptr result)
-      : SimpleVinograd(first, second, result){};
-  ~PipeVinograd() = default;
+  /// @param t_num number of threads of the main loop
+  BasicPipeVinograd(const_matrix_ptr first, const_matrix_ptr second,
+                    matrix_ptr result, std::size_t t_num = 1);
+  ~BasicPipeVinograd() = default;
 
   /// @brief multiplies two matrices
   virtual void Multiply() override;
 
 private:
-  std::mutex mtx_a_;
-  std::future<void> future_one_;
-  std::future<void> future_two_;
+  using Bands = BoundedQueue<std::pair<size_t, size_t>>;
+  using BasicSimpleVinograd<T>::first_;
+  using BasicSimpleVinograd<T>::f_rows_;
+  using BasicSimpleVinograd<T>::f_cols_;
+  using BasicSimpleVinograd<T>::s_cols_;
+  using BasicSimpleVinograd<T>::row_factor_;
 
-  void MultiplyPartialMatrix(size_t start, size_t end);
+  std::size_t threads_num_;
+  std::size_t band_rows_;
+
+  template <bool kOdd> void ProduceBands(Bands &bands);
+  template <bool kOdd> void ConsumeBands(Bands &bands);
 };
 
-class ParallelVinograd : public SimpleVinograd {
+/// @brief parallel Winograd multiplication. Factors are computed in parallel
+/// (rows and columns are split between threads), then the result is split
+/// into 2D tiles handed out to threads dynamically through an atomic
+/// counter, so that wide or tall results keep all threads busy and a slow
+/// thread does not stall the others.
+template <typename T>
+class BasicParallelVinograd : public BasicSimpleVinograd<T> {
 public:
+  using typename BasicSimpleVinograd<T>::matrix_ptr;
+  using typename BasicSimpleVinograd<T>::const_matrix_ptr;
+
+  /// @brief tiles per thread when their sizes are derived
+  static constexpr std::size_t kTilesPerThread = 4;
+
   /// @brief ctor
   /// @param first first matrix
   /// @param second second matrix
   /// @param result result matrix
   /// @param t_num number of threads
-  ParallelVinograd(m_ptr first, m_ptr second, m_ptr result,
-                   std::size_t t_num = 1)
-      : SimpleVinograd(first, second, result), threads_num_(t_num){};
-  ~ParallelVinograd() = default;
+  /// @param tile_rows rows of a tile, 0 - derived from the shape
+  /// @param tile_cols columns of a tile, 0 - derived from the shape
+  BasicParallelVinograd(const_matrix_ptr first, const_matrix_ptr second,
+                        matrix_ptr result, std::size_t t_num = 1,
+                        std::size_t tile_rows = 0, std::size_t tile_cols = 0);
+  ~BasicParallelVinograd() = default;
 
   /// @brief launches multiplying
   virtual void Multiply() override;
 
+  /// @brief rows of a tile
+  std::size_t GetTileRows() const { return tile_rows_; }
+  /// @brief columns of a tile
+  std::size_t GetTileCols() const { return tile_cols_; }
+
+private:
+  using BasicSimpleVinograd<T>::first_;
+  using BasicSimpleVinograd<T>::second_;
+  using BasicSimpleVinograd<T>::f_rows_;
+  using BasicSimpleVinograd<T>::f_cols_;
+  using BasicSimpleVinograd<T>::s_cols_;
+  using BasicSimpleVinograd<T>::row_factor_;
+  using BasicSimpleVinograd<T>::col_factor_;
+
+  std::size_t threads_num_;
+  std::size_t tile_rows_;
+  std::size_t tile_cols_;
+  std::size_t row_tiles_ = 0;
+  std::size_t col_tiles_ = 0;
+  std::atomic<std::size_t> next_tile_{0};
+
+  void ComputeFactors();
+  template <bool kOdd> void MultiplyTiles();
+};
+
+extern template class BasicSimpleVinograd<float>;
+extern template class BasicSimpleVinograd<double>;
+extern template class BasicSimpleVinograd<std::int64_t>;
+extern template class BasicPipeVinograd<float>;
+extern template class BasicPipeVinograd<double>;
+extern template class BasicPipeVinograd<std::int64_t>;
+extern template class BasicParallelVinograd<float>;
+extern template class BasicParallelVinograd<double>;
+extern template class BasicParallelVinograd<std::int64_t>;
+
+using Vinograd = BasicVinograd<double>;
+using SimpleVinograd = BasicSimpleVinograd<double>;
+using PipeVinograd = BasicPipeVinograd<double>;
+using ParallelVinograd = BasicParallelVinograd<double>;
+
+/// @brief recomputes a result after some rows of the first matrix and some
+/// columns of the second one were changed. Only the factors of the changed
+/// rows and columns are recomputed, then the changed rows of the result
+/// and the changed columns of the other rows: O((rows + cols) * n^2) work
+/// instead of O(n^3). The factors are kept between updates; Invalidate
+/// makes the next Update recompute all of them (O(n^2)).
+class IncrementalVinograd : public SimpleVinograd {
+public:
+  /// @brief ctor
+  /// @param first first matrix
+  /// @param second second matrix
+  /// @param result result matrix, must hold the product of the matrices
+  /// before their rows and columns were changed
+  /// @param t_num number of threads
+  IncrementalVinograd(const_m_ptr first, const_m_ptr second, m_ptr result,
+                      std::size_t t_num = 1)
+      : SimpleVinograd(first, second, result),
+        threads_num_(std::max<std::size_t>(t_num, 1)){};
+  ~IncrementalVinograd() = default;
+
+  /// @brief multiplies two matrices from scratch
+  void Multiply() override;
+
+  /// @brief recomputes changed rows and columns of the result
+  /// @param rows changed rows of the first matrix, without repetitions
+  /// @param cols changed columns of the second matrix, without repetitions
+  void Update(const std::vector<std::size_t> &rows,
+              const std::vector<std::size_t> &cols);
+
+  /// @brief factors are outdated, e.g. the result was computed by another
+  /// engine meanwhile
+  void Invalidate() { factors_ready_ = false; }
+
 private:
-  std::once_flag flag_one_;
-  std::once_flag flag_two_;
-  std::once_flag flag_three_;
   std::size_t threads_num_;
+  bool factors_ready_ = false;
+};
+
+/// @brief sizes of blocks of BlockedVinograd, 0 - derived from cache sizes
+struct VinogradTiles {
+  std::size_t rows = 0;  // rows of the first matrix per block
+  std::size_t cols = 0;  // columns of the second matrix per packed block
+  std::size_t pairs = 0; // pairs of inner dimension per packed block
+};
+
+/// @brief cache-blocked Winograd multiplication. Columns of the second
+/// matrix are packed into contiguous micro-panels of kMicroCols columns in
+/// which both rows of every pair (2k + 1, 2k) follow each other, and the
+/// i/j/k loops are tiled so that a micro-panel stays in L1, a block of rows
+/// of the first matrix in L2 and the packed block of the second matrix in
+/// L3. Every micro-tile kMicroRows x kMicroCols is accumulated in registers.
+class BlockedVinograd : public SimpleVinograd {
+public:
+  using Tiles = VinogradTiles;
+
+  static constexpr std::size_t kMicroRows = kVinogradMicroRows;
+  static constexpr std::size_t kMicroCols = kVinogradMicroCols;
+
+  /// @brief ctor
+  /// @param first first matrix
+  /// @param second second matrix
+  /// @param result result matrix
+  /// @param tiles sizes of blocks, missing ones are derived from caches
+  BlockedVinograd(const_m_ptr first, const_m_ptr second, m_ptr result,
+                  Tiles tiles = Tiles());
+  ~BlockedVinograd() = default;
+
+  /// @brief multiplies two matrices
+  void Multiply() override;
+
+  /// @brief sizes of blocks in use
+  const Tiles &GetTiles() const { return tiles_; }
+
+  /// @brief derives missing sizes of blocks from cache sizes
+  /// @param tiles requested sizes, 0 - to be derived
+  /// @param caches cache sizes
+  static Tiles AdjustTiles(Tiles tiles, const CacheSizes &caches);
+
+protected:
+  Tiles tiles_;
+  /// @brief packed block of the second matrix: one micro-panel per row
+  m_dbl_type packed_;
+
+  void PackBlock(std::size_t col, std::size_t cols, std::size_t pair,
+                 std::size_t pairs);
+  void MultiplyBlock(std::size_t row, std::size_t rows, std::size_t col,
+                     std::size_t cols, std::size_t pair, std::size_t pairs);
+  void MultiplyMicroTile(std::size_t row, std::size_t rows, std::size_t col,
+                         std::size_t cols, std::size_t pair,
+                         std::size_t pairs, const double *panel);
+};
+
+/// @brief Strassen-Winograd multiplication: every level multiplies 7 pairs
+/// of quadrants (with 15 additions) instead of 8. The recursion stops when
+/// the smallest dimension is not above the cutoff, leaves are multiplied by
+/// the micro-tile kernels of BlockedVinograd (smaller matrices entirely by
+/// BlockedVinograd). Dimensions are padded with zeros up to multiples of
+/// 2^depth (the inner one up to 2^(depth + 1), so leaves have no odd
+/// column). The seven products of the upper levels run as tasks of the
+/// thread pool. Padded copies and all temporaries are allocated by the ctor
+/// and reused by every Multiply.
+class StrassenVinograd : public SimpleVinograd {
+public:
+  static constexpr std::size_t kDefaultCutoff = 512;
+
+  /// @brief ctor
+  /// @param first first matrix
+  /// @param second second matrix
+  /// @param result result matrix
+  /// @param cutoff largest smallest dimension multiplied without recursion
+  /// @param t_num number of threads
+  StrassenVinograd(const_m_ptr first, const_m_ptr second, m_ptr result,
+                   std::size_t cutoff = kDefaultCutoff, std::size_t t_num = 1);
+  ~StrassenVinograd() = default;
+
+  /// @brief multiplies two matrices
+  void Multiply() override;
+
+  /// @brief levels of recursion, 0 - plain Winograd multiplication
+  std::size_t GetDepth() const { return depth_; }
+
+  /// @brief number of doubles of scratch memory
+  std::size_t GetScratchSize() const { return scratch_.size(); }
+
+protected:
+  using const_view = MatrixView<const double>;
+  using view = MatrixView<double>;
+
+  std::size_t cutoff_;
+  std::size_t threads_num_;
+  std::size_t depth_ = 0;
+  /// @brief levels whose products run in parallel
+  std::size_t parallel_depth_ = 0;
+  m_dbl_type padded_first_;
+  m_dbl_type padded_second_;
+  m_dbl_type padded_result_;
+  row_type scratch_;
+  /// @brief engine for matrices below the cutoff (depth 0)
+  std::unique_ptr<BlockedVinograd> blocked_;
 
-  void MultiplyPartial(size_t start, size_t end);
+  std::size_t ScratchSize(std::size_t rows, std::size_t inner,
+                          std::size_t cols, std::size_t level) const;
+  void MultiplyRecursive(const_view a, const_view b, view c, std::size_t level,
+                         double *scratch);
+  void MultiplySequential(const_view a, const_view b, view c,
+                          std::size_t level, double *scratch);
+  void MultiplyParallel(const_view a, const_view b, view c, std::size_t level,
+                        double *scratch);
+  void MultiplyLeaf(const_view a, const_view b, view c, double *scratch);
+  /// @brief z = x + sign * y, z may be x or y
+  void Add(const_view x, const_view y, view z, double sign,
+           std::size_t level) const;
 };
 
 } // namespace s21
@@ -0,0 +1,205 @@
+#include "s21_vinograd_batch.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "s21_thread_pool.h"
+#include "s21_topology.h"
+#include "s21_trace.h"
+
+namespace s21 {
+
+BatchVinograd::BatchVinograd(const_m_ptr shared, Side side)
+    : shared_(shared), side_(side) {
+  if (!shared_ || shared_->empty()) {
+    throw "";
+  }
+  S21_TRACE_SCOPE("PackShared");
+  constexpr std::size_t kCols = kVinogradMicroCols;
+  const m_dbl_type &matrix = *shared_;
+  // the shared operand is the second one of the kernels, transposed for kLeft
+  const_view second = side_ == Side::kRight ? matrix.View()
+                                            : matrix.View().Transposed();
+  inner_ = second.rows();
+  cols_ = second.cols();
+  const std::size_t pairs = inner_ / 2;
+
+  col_factor_.assign(cols_, 0.0);
+  if (side_ == Side::kRight) {
+    for (std::size_t k = 0; k < pairs; ++k) {
+      kernels_->col_factor(matrix[2 * k], matrix[2 * k + 1], cols_,
+                           col_factor_.data());
+    }
+  } else {
+    for (std::size_t j = 0; j < cols_; ++j) {
+      col_factor_[j] = kernels_->row_factor(matrix[j], pairs);
+    }
+  }
+  if (inner_ % 2 != 0) {
+    last_.resize(cols_);
+    for (std::size_t j = 0; j < cols_; ++j) {
+      last_[j] = second(inner_ - 1, j);
+    }
+  }
+
+  // the same micro-panels as in BlockedVinograd, over the whole inner
+  // dimension; the zero padding of the last panel comes from Matrix
+  packed_ = m_dbl_type((cols_ + kCols - 1) / kCols, 2 * kCols * pairs);
+  for (std::size_t j = 0; j < cols_; j += kCols) {
+    double *panel = packed_[j / kCols];
+    const std::size_t width = std::min(kCols, cols_ - j);
+    for (std::size_t k = 0; k < pairs; ++k) {
+      double *odd = panel + 2 * kCols * k;
+      double *even = odd + kCols;
+      for (std::size_t c = 0; c < width; ++c) {
+        odd[c] = second(2 * k + 1, j + c);
+        even[c] = second(2 * k, j + c);
+      }
+    }
+  }
+}
+
+void BatchVinograd::CheckShape(const m_dbl_type &other) const {
+  std::size_t inner = side_ == Side::kRight ? other.cols() : other.rows();
+  if (other.empty() || inner != inner_) {
+    throw "";
+  }
+}
+
+m_dbl_type BatchVinograd::Allocate(const m_dbl_type &other) const {
+  if (side_ == Side::kRight) {
+    return m_dbl_type(other.rows(), cols_);
+  }
+  return m_dbl_type(cols_, other.cols());
+}
+
+void BatchVinograd::Multiply(const m_dbl_type &other,
+                             m_dbl_type &result) const {
+  CheckShape(other);
+  if (result.rows() != (side_ == Side::kRight ? other.rows() : cols_) ||
+      result.cols() != (side_ == Side::kRight ? cols_ : other.cols())) {
+    result = Allocate(other);
+  }
+  MultiplyRange(other, result, 0,
+                side_ == Side::kRight ? other.rows() : other.cols());
+}
+
+std::vector<m_dbl_type>
+BatchVinograd::MultiplyBatch(const std::vector<const_m_ptr> &others,
+                             std::size_t t_num) const {
+  std::vector<m_dbl_type> results;
+  results.reserve(others.size());
+  for (auto &other : others) {
+    if (!other) {
+      throw "";
+    }
+    CheckShape(*other);
+    results.push_back(Allocate(*other));
+  }
+  if (others.empty()) {
+    return results;
+  }
+
+  // small batches are split into bands so that every thread gets work
+  t_num = std::max<std::size_t>(t_num, 1);
+  const std::size_t bands = (t_num + others.size() - 1) / others.size();
+  const std::size_t units = others.size() * bands;
+  std::atomic<std::size_t> next_unit{0};
+  auto worker = [&]() {
+    for (std::size_t unit = next_unit++; unit < units; unit = next_unit++) {
+      const m_dbl_type &other = *others[unit / bands];
+      const std::size_t band = unit % bands;
+      const std::size_t span =
+          side_ == Side::kRight ? other.rows() : other.cols();
+      MultiplyRange(other, results[unit / bands], span * band / bands,
+                    span * (band + 1) / bands);
+    }
+  };
+
+  TaskGroup group;
+  for (std::size_t i = 1; i < std::min(t_num, units); ++i) {
+    group.Run(worker);
+  }
+  worker();
+  group.Wait();
+  return results;
+}
+
+void BatchVinograd::MultiplyRange(const m_dbl_type &other, m_dbl_type &result,
+                                  std::size_t start, std::size_t end) const {
+  if (start >= end) {
+    return;
+  }
+  if (side_ == Side::kRight) {
+    MultiplyRows(other.View(), result.View(), start, end);
+    return;
+  }
+  // rows of other^T are columns [start, end) of other
+  m_dbl_type transposed(end - start, inner_);
+  {
+    S21_TRACE_SCOPE("TransposeOperand");
+    for (std::size_t k = 0; k < inner_; ++k) {
+      const double *row = other[k];
+      for (std::size_t j = start; j < end; ++j) {
+        transposed(j - start, k) = row[j];
+      }
+    }
+  }
+  MultiplyRows(transposed.View(),
+               result.View().Transposed().Block(start, 0, end - start, cols_),
+               0, end - start);
+}
+
+void BatchVinograd::MultiplyRows(const_view a, view c, std::size_t start,
+                                 std::size_t end) const {
+  S21_TRACE_SCOPE("MultiplyBatchRows");
+  constexpr std::size_t kRows = kVinogradMicroRows;
+  constexpr std::size_t kCols = kVinogradMicroCols;
+  const std::size_t pairs = inner_ / 2;
+  const std::size_t panels = packed_.rows();
+  // a block of panels takes half of L2 and is reused by all rows
+  const std::size_t panel_bytes = 2 * kCols * pairs * sizeof(double);
+  const std::size_t block = std::max<std::size_t>(
+      Topology::Instance().Caches().l2 / 2 / std::max<std::size_t>(
+                                                 panel_bytes, 1),
+      1);
+
+  double acc[kRows * kCols];
+  double row_factor[kRows];
+  const double *rows[kRows];
+  for (std::size_t first = 0; first < panels; first += block) {
+    const std::size_t last = std::min(first + block, panels);
+    for (std::size_t i = start; i < end; i += kRows) {
+      const std::size_t height = std::min(kRows, end - i);
+      // kernels read all kRows rows, missing ones repeat the first row
+      for (std::size_t r = 0; r < kRows; ++r) {
+        rows[r] = &a(i + (r < height ? r : 0), 0);
+      }
+      for (std::size_t r = 0; r < height; ++r) {
+        row_factor[r] = kernels_->row_factor(rows[r], pairs);
+      }
+      for (std::size_t p = first; p < last; ++p) {
+        const std::size_t col = p * kCols;
+        const std::size_t width = std::min(kCols, cols_ - col);
+        if (pairs > 0) {
+          kernels_->micro_tile(rows, packed_[p], pairs, acc);
+        } else {
+          std::fill(acc, acc + kRows * kCols, 0.0);
+        }
+        for (std::size_t r = 0; r < height; ++r) {
+          const double bias = last_.empty() ? 0.0 : a(i + r, inner_ - 1);
+          for (std::size_t j = 0; j < width; ++j) {
+            double value = acc[r * kCols + j] - row_factor[r] -
+                           col_factor_[col + j];
+            if (!last_.empty()) {
+              value += bias * last_[col + j];
+            }
+            c(i + r, col + j) = value;
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace s21
@@ -0,0 +1,85 @@
+#ifndef PARALLELS_SRC_LIB_S21_VINOGRAD_BATCH_H_
+#define PARALLELS_SRC_LIB_S21_VINOGRAD_BATCH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_types.h"
+#include "s21_vinograd_kernels.h"
+
+namespace s21 {
+
+/// @brief Winograd multiplication of many matrices by one shared operand.
+/// The factors of the shared operand are computed and it is packed into
+/// micro-panels (see BlockedVinograd) once, by the ctor; every product then
+/// only computes the factors of its own operand. The shared operand is either
+/// the second one (x * shared) or the first one (shared * x); in the latter
+/// case the products are computed as (x^T * shared^T)^T, x^T is a copy made
+/// per product and the result is written transposed.
+class BatchVinograd {
+public:
+  /// @brief position of the shared operand in the products
+  enum class Side {
+    kRight, // others[i] * shared
+    kLeft   // shared * others[i]
+  };
+
+  /// @brief ctor. Packs the shared operand
+  /// @param shared shared operand, must stay alive while the engine is used
+  /// @param side position of the shared operand
+  BatchVinograd(const_m_ptr shared, Side side = Side::kRight);
+  ~BatchVinograd() = default;
+
+  /// @brief multiplies one matrix by the shared operand. Does not change the
+  /// engine, so several threads may call it at once
+  /// @param other the other operand
+  /// @param result product, rows x cols of the result
+  /// @throw if the shapes do not match
+  void Multiply(const m_dbl_type &other, m_dbl_type &result) const;
+
+  /// @brief multiplies every matrix of the batch by the shared operand. The
+  /// batch is spread between threads of the pool, matrices are split into
+  /// row bands when the batch is smaller than the number of threads
+  /// @param others other operands
+  /// @param t_num number of threads
+  /// @return products in the order of "others"
+  /// @throw if the shapes do not match
+  std::vector<m_dbl_type> MultiplyBatch(const std::vector<const_m_ptr> &others,
+                                        std::size_t t_num = 1) const;
+
+  Side GetSide() const { return side_; }
+
+  /// @brief replaces inner loops, e.g. to compare instruction sets
+  /// @param kernels kernels supported by the CPU
+  void SetKernels(const VinogradKernels &kernels) { kernels_ = &kernels; }
+
+private:
+  using const_view = MatrixView<const double>;
+  using view = MatrixView<double>;
+
+  const_m_ptr shared_;
+  Side side_;
+  /// @brief inner dimension of the products
+  std::size_t inner_;
+  /// @brief columns of the products computed by the kernels (columns of
+  /// shared for kRight, rows of shared for kLeft)
+  std::size_t cols_;
+  /// @brief one micro-panel over all pairs per row
+  m_dbl_type packed_;
+  row_type col_factor_;
+  /// @brief last row of the "second" operand, for odd inner dimension
+  row_type last_;
+  const VinogradKernels *kernels_ = &DefaultVinogradKernels();
+
+  void CheckShape(const m_dbl_type &other) const;
+  m_dbl_type Allocate(const m_dbl_type &other) const;
+  /// @brief computes rows [start, end) of a * second into c
+  void MultiplyRows(const_view a, view c, std::size_t start,
+                    std::size_t end) const;
+  void MultiplyRange(const m_dbl_type &other, m_dbl_type &result,
+                     std::size_t start, std::size_t end) const;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_VINOGRAD_BATCH_H_
@@ -0,0 +1,449 @@
+#include "s21_vinograd_kernels.h"
+
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_X86_KERNELS
+#define S21_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define S21_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr std::size_t kRows = kVinogradMicroRows;
+constexpr std::size_t kCols = kVinogradMicroCols;
+
+/////////////////////////////////////////////////////////////////////////////
+// portable kernels, also used for tails of vector ones
+/////////////////////////////////////////////////////////////////////////////
+
+double RowFactorScalar(const double *row, std::size_t pairs) {
+  double sum = 0.0;
+  for (std::size_t k = 0; k < pairs; ++k) {
+    sum += row[2 * k] * row[2 * k + 1];
+  }
+  return sum;
+}
+
+void ColFactorRange(const double *even, const double *odd, std::size_t begin,
+                    std::size_t end, double *factor) {
+  for (std::size_t j = begin; j < end; ++j) {
+    factor[j] += even[j] * odd[j];
+  }
+}
+
+void ColFactorScalar(const double *even, const double *odd, std::size_t cols,
+                     double *factor) {
+  ColFactorRange(even, odd, 0, cols, factor);
+}
+
+void MainRowRange(const double *a, const double *b, std::size_t stride,
+                  std::size_t pairs, std::size_t begin, std::size_t end,
+                  double row_factor, const double *col_factor, double *res) {
+  for (std::size_t j = begin; j < end; ++j) {
+    double sum = -row_factor - col_factor[j];
+    for (std::size_t k = 0; k < pairs; ++k) {
+      sum += (a[2 * k] + b[(2 * k + 1) * stride + j]) *
+             (a[2 * k + 1] + b[2 * k * stride + j]);
+    }
+    res[j] = sum;
+  }
+}
+
+void MainRowScalar(const double *a, const double *b, std::size_t stride,
+                   std::size_t pairs, std::size_t cols, double row_factor,
+                   const double *col_factor, double *res) {
+  MainRowRange(a, b, stride, pairs, 0, cols, row_factor, col_factor, res);
+}
+
+void MicroTileScalar(const double *const *a, const double *panel,
+                     std::size_t pairs, double *acc) {
+  for (std::size_t i = 0; i < kRows * kCols; ++i) {
+    acc[i] = 0.0;
+  }
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const double *odd = panel + 2 * kCols * k;
+    const double *even = odd + kCols;
+    for (std::size_t r = 0; r < kRows; ++r) {
+      const double a0 = a[r][2 * k];
+      const double a1 = a[r][2 * k + 1];
+      for (std::size_t c = 0; c < kCols; ++c) {
+        acc[r * kCols + c] += (a0 + odd[c]) * (a1 + even[c]);
+      }
+    }
+  }
+}
+
+#ifdef S21_X86_KERNELS
+
+/////////////////////////////////////////////////////////////////////////////
+// SSE2: 2 doubles per register, no FMA
+/////////////////////////////////////////////////////////////////////////////
+
+double RowFactorSse2(const double *row, std::size_t pairs) {
+  __m128d sum = _mm_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 2 <= pairs; k += 2) {
+    __m128d first = _mm_loadu_pd(row + 2 * k);
+    __m128d second = _mm_loadu_pd(row + 2 * k + 2);
+    sum = _mm_add_pd(sum, _mm_mul_pd(_mm_unpacklo_pd(first, second),
+                                     _mm_unpackhi_pd(first, second)));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, sum);
+  return lanes[0] + lanes[1] + RowFactorScalar(row + 2 * k, pairs - k);
+}
+
+void ColFactorSse2(const double *even, const double *odd, std::size_t cols,
+                   double *factor) {
+  std::size_t j = 0;
+  for (; j + 2 <= cols; j += 2) {
+    __m128d product = _mm_mul_pd(_mm_loadu_pd(even + j), _mm_loadu_pd(odd + j));
+    _mm_storeu_pd(factor + j, _mm_add_pd(_mm_loadu_pd(factor + j), product));
+  }
+  ColFactorRange(even, odd, j, cols, factor);
+}
+
+void MainRowSse2(const double *a, const double *b, std::size_t stride,
+                 std::size_t pairs, std::size_t cols, double row_factor,
+                 const double *col_factor, double *res) {
+  const __m128d start = _mm_set1_pd(-row_factor);
+  std::size_t j = 0;
+  for (; j + 2 <= cols; j += 2) {
+    __m128d sum = _mm_sub_pd(start, _mm_loadu_pd(col_factor + j));
+    for (std::size_t k = 0; k < pairs; ++k) {
+      __m128d odd = _mm_loadu_pd(b + (2 * k + 1) * stride + j);
+      __m128d even = _mm_loadu_pd(b + 2 * k * stride + j);
+      sum = _mm_add_pd(sum, _mm_mul_pd(_mm_add_pd(_mm_set1_pd(a[2 * k]), odd),
+                                       _mm_add_pd(_mm_set1_pd(a[2 * k + 1]),
+                                                  even)));
+    }
+    _mm_storeu_pd(res + j, sum);
+  }
+  MainRowRange(a, b, stride, pairs, j, cols, row_factor, col_factor, res);
+}
+
+void MicroTileSse2(const double *const *a, const double *panel,
+                   std::size_t pairs, double *acc) {
+  constexpr std::size_t kVectors = kCols / 2;
+  __m128d sum[kRows][kVectors];
+  for (std::size_t r = 0; r < kRows; ++r) {
+    for (std::size_t v = 0; v < kVectors; ++v) {
+      sum[r][v] = _mm_setzero_pd();
+    }
+  }
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const double *odd = panel + 2 * kCols * k;
+    const double *even = odd + kCols;
+    for (std::size_t r = 0; r < kRows; ++r) {
+      __m128d a0 = _mm_set1_pd(a[r][2 * k]);
+      __m128d a1 = _mm_set1_pd(a[r][2 * k + 1]);
+      for (std::size_t v = 0; v < kVectors; ++v) {
+        __m128d left = _mm_add_pd(a0, _mm_loadu_pd(odd + 2 * v));
+        __m128d right = _mm_add_pd(a1, _mm_loadu_pd(even + 2 * v));
+        sum[r][v] = _mm_add_pd(sum[r][v], _mm_mul_pd(left, right));
+      }
+    }
+  }
+  for (std::size_t r = 0; r < kRows; ++r) {
+    for (std::size_t v = 0; v < kVectors; ++v) {
+      _mm_storeu_pd(acc + r * kCols + 2 * v, sum[r][v]);
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AVX2 + FMA: 4 doubles per register
+/////////////////////////////////////////////////////////////////////////////
+
+S21_TARGET_AVX2 double RowFactorAvx2(const double *row, std::size_t pairs) {
+  __m256d sum = _mm256_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 4 <= pairs; k += 4) {
+    __m256d first = _mm256_loadu_pd(row + 2 * k);
+    __m256d second = _mm256_loadu_pd(row + 2 * k + 4);
+    sum = _mm256_fmadd_pd(_mm256_unpacklo_pd(first, second),
+                          _mm256_unpackhi_pd(first, second), sum);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, sum);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+         RowFactorScalar(row + 2 * k, pairs - k);
+}
+
+S21_TARGET_AVX2 void ColFactorAvx2(const double *even, const double *odd,
+                                   std::size_t cols, double *factor) {
+  std::size_t j = 0;
+  for (; j + 4 <= cols; j += 4) {
+    _mm256_storeu_pd(factor + j, _mm256_fmadd_pd(_mm256_loadu_pd(even + j),
+                                                 _mm256_loadu_pd(odd + j),
+                                                 _mm256_loadu_pd(factor + j)));
+  }
+  ColFactorRange(even, odd, j, cols, factor);
+}
+
+S21_TARGET_AVX2 void MainRowAvx2(const double *a, const double *b,
+                                 std::size_t stride, std::size_t pairs,
+                                 std::size_t cols, double row_factor,
+                                 const double *col_factor, double *res) {
+  const __m256d start = _mm256_set1_pd(-row_factor);
+  std::size_t j = 0;
+  // four registers at once hide latency of FMA
+  for (; j + 16 <= cols; j += 16) {
+    __m256d sum[4];
+    for (std::size_t v = 0; v < 4; ++v) {
+      sum[v] = _mm256_sub_pd(start, _mm256_loadu_pd(col_factor + j + 4 * v));
+    }
+    for (std::size_t k = 0; k < pairs; ++k) {
+      const double *odd = b + (2 * k + 1) * stride + j;
+      const double *even = b + 2 * k * stride + j;
+      __m256d a0 = _mm256_set1_pd(a[2 * k]);
+      __m256d a1 = _mm256_set1_pd(a[2 * k + 1]);
+      for (std::size_t v = 0; v < 4; ++v) {
+        sum[v] = _mm256_fmadd_pd(
+            _mm256_add_pd(a0, _mm256_loadu_pd(odd + 4 * v)),
+            _mm256_add_pd(a1, _mm256_loadu_pd(even + 4 * v)), sum[v]);
+      }
+    }
+    for (std::size_t v = 0; v < 4; ++v) {
+      _mm256_storeu_pd(res + j + 4 * v, sum[v]);
+    }
+  }
+  for (; j + 4 <= cols; j += 4) {
+    __m256d sum = _mm256_sub_pd(start, _mm256_loadu_pd(col_factor + j));
+    for (std::size_t k = 0; k < pairs; ++k) {
+      __m256d odd = _mm256_loadu_pd(b + (2 * k + 1) * stride + j);
+      __m256d even = _mm256_loadu_pd(b + 2 * k * stride + j);
+      sum = _mm256_fmadd_pd(_mm256_add_pd(_mm256_set1_pd(a[2 * k]), odd),
+                            _mm256_add_pd(_mm256_set1_pd(a[2 * k + 1]), even),
+                            sum);
+    }
+    _mm256_storeu_pd(res + j, sum);
+  }
+  MainRowRange(a, b, stride, pairs, j, cols, row_factor, col_factor, res);
+}
+
+S21_TARGET_AVX2 void MicroTileAvx2(const double *const *a, const double *panel,
+                                   std::size_t pairs, double *acc) {
+  __m256d sum[kRows][2];
+  for (std::size_t r = 0; r < kRows; ++r) {
+    sum[r][0] = _mm256_setzero_pd();
+    sum[r][1] = _mm256_setzero_pd();
+  }
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const double *odd = panel + 2 * kCols * k;
+    const double *even = odd + kCols;
+    __m256d odd0 = _mm256_loadu_pd(odd);
+    __m256d odd1 = _mm256_loadu_pd(odd + 4);
+    __m256d even0 = _mm256_loadu_pd(even);
+    __m256d even1 = _mm256_loadu_pd(even + 4);
+    for (std::size_t r = 0; r < kRows; ++r) {
+      __m256d a0 = _mm256_set1_pd(a[r][2 * k]);
+      __m256d a1 = _mm256_set1_pd(a[r][2 * k + 1]);
+      sum[r][0] = _mm256_fmadd_pd(_mm256_add_pd(a0, odd0),
+                                  _mm256_add_pd(a1, even0), sum[r][0]);
+      sum[r][1] = _mm256_fmadd_pd(_mm256_add_pd(a0, odd1),
+                                  _mm256_add_pd(a1, even1), sum[r][1]);
+    }
+  }
+  for (std::size_t r = 0; r < kRows; ++r) {
+    _mm256_storeu_pd(acc + r * kCols, sum[r][0]);
+    _mm256_storeu_pd(acc + r * kCols + 4, sum[r][1]);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AVX-512: 8 doubles per register, masked tails
+/////////////////////////////////////////////////////////////////////////////
+
+S21_TARGET_AVX512 double RowFactorAvx512(const double *row,
+                                         std::size_t pairs) {
+  __m512d sum = _mm512_setzero_pd();
+  std::size_t k = 0;
+  for (; k + 8 <= pairs; k += 8) {
+    __m512d first = _mm512_loadu_pd(row + 2 * k);
+    __m512d second = _mm512_loadu_pd(row + 2 * k + 8);
+    // maskz forms avoid false -Wmaybe-uninitialized of GCC 12 headers
+    sum = _mm512_fmadd_pd(_mm512_maskz_unpacklo_pd(0xFF, first, second),
+                          _mm512_maskz_unpackhi_pd(0xFF, first, second), sum);
+  }
+  double lanes[8];
+  _mm512_storeu_pd(lanes, sum);
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+         ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7])) +
+         RowFactorScalar(row + 2 * k, pairs - k);
+}
+
+S21_TARGET_AVX512 void ColFactorAvx512(const double *even, const double *odd,
+                                       std::size_t cols, double *factor) {
+  for (std::size_t j = 0; j < cols; j += 8) {
+    __mmask8 mask = (cols - j >= 8) ? 0xFF : (1u << (cols - j)) - 1;
+    __m512d sum = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, even + j),
+                                  _mm512_maskz_loadu_pd(mask, odd + j),
+                                  _mm512_maskz_loadu_pd(mask, factor + j));
+    _mm512_mask_storeu_pd(factor + j, mask, sum);
+  }
+}
+
+S21_TARGET_AVX512 void MainRowAvx512(const double *a, const double *b,
+                                     std::size_t stride, std::size_t pairs,
+                                     std::size_t cols, double row_factor,
+                                     const double *col_factor, double *res) {
+  const __m512d start = _mm512_set1_pd(-row_factor);
+  std::size_t j = 0;
+  // four registers at once hide latency of FMA
+  for (; j + 32 <= cols; j += 32) {
+    __m512d sum[4];
+    for (std::size_t v = 0; v < 4; ++v) {
+      sum[v] = _mm512_sub_pd(start, _mm512_loadu_pd(col_factor + j + 8 * v));
+    }
+    for (std::size_t k = 0; k < pairs; ++k) {
+      const double *odd = b + (2 * k + 1) * stride + j;
+      const double *even = b + 2 * k * stride + j;
+      __m512d a0 = _mm512_set1_pd(a[2 * k]);
+      __m512d a1 = _mm512_set1_pd(a[2 * k + 1]);
+      for (std::size_t v = 0; v < 4; ++v) {
+        sum[v] = _mm512_fmadd_pd(
+            _mm512_add_pd(a0, _mm512_loadu_pd(odd + 8 * v)),
+            _mm512_add_pd(a1, _mm512_loadu_pd(even + 8 * v)), sum[v]);
+      }
+    }
+    for (std::size_t v = 0; v < 4; ++v) {
+      _mm512_storeu_pd(res + j + 8 * v, sum[v]);
+    }
+  }
+  for (; j < cols; j += 8) {
+    __mmask8 mask = (cols - j >= 8) ? 0xFF : (1u << (cols - j)) - 1;
+    __m512d sum =
+        _mm512_sub_pd(start, _mm512_maskz_loadu_pd(mask, col_factor + j));
+    for (std::size_t k = 0; k < pairs; ++k) {
+      __m512d odd = _mm512_maskz_loadu_pd(mask, b + (2 * k + 1) * stride + j);
+      __m512d even = _mm512_maskz_loadu_pd(mask, b + 2 * k * stride + j);
+      sum = _mm512_fmadd_pd(_mm512_add_pd(_mm512_set1_pd(a[2 * k]), odd),
+                            _mm512_add_pd(_mm512_set1_pd(a[2 * k + 1]), even),
+                            sum);
+    }
+    _mm512_mask_storeu_pd(res + j, mask, sum);
+  }
+}
+
+S21_TARGET_AVX512 void MicroTileAvx512(const double *const *a,
+                                       const double *panel, std::size_t pairs,
+                                       double *acc) {
+  static_assert(kCols == 8, "micro-panel must fit one AVX-512 register");
+  __m512d sum[kRows];
+  for (std::size_t r = 0; r < kRows; ++r) {
+    sum[r] = _mm512_setzero_pd();
+  }
+  for (std::size_t k = 0; k < pairs; ++k) {
+    __m512d odd = _mm512_loadu_pd(panel + 2 * kCols * k);
+    __m512d even = _mm512_loadu_pd(panel + 2 * kCols * k + kCols);
+    for (std::size_t r = 0; r < kRows; ++r) {
+      sum[r] = _mm512_fmadd_pd(
+          _mm512_add_pd(_mm512_set1_pd(a[r][2 * k]), odd),
+          _mm512_add_pd(_mm512_set1_pd(a[r][2 * k + 1]), even), sum[r]);
+    }
+  }
+  for (std::size_t r = 0; r < kRows; ++r) {
+    _mm512_storeu_pd(acc + r * kCols, sum[r]);
+  }
+}
+
+#endif // S21_X86_KERNELS
+
+const VinogradKernels kScalarKernels = {SimdLevel::kScalar, RowFactorScalar,
+                                        ColFactorScalar, MainRowScalar,
+                                        MicroTileScalar};
+#ifdef S21_X86_KERNELS
+const VinogradKernels kSse2Kernels = {SimdLevel::kSse2, RowFactorSse2,
+                                      ColFactorSse2, MainRowSse2,
+                                      MicroTileSse2};
+const VinogradKernels kAvx2Kernels = {SimdLevel::kAvx2, RowFactorAvx2,
+                                      ColFactorAvx2, MainRowAvx2,
+                                      MicroTileAvx2};
+const VinogradKernels kAvx512Kernels = {SimdLevel::kAvx512, RowFactorAvx512,
+                                        ColFactorAvx512, MainRowAvx512,
+                                        MicroTileAvx512};
+#endif
+
+bool IsSupported(SimdLevel level) {
+#ifdef S21_X86_KERNELS
+  __builtin_cpu_init();
+  switch (level) {
+  case SimdLevel::kAvx512:
+    return __builtin_cpu_supports("avx512f");
+  case SimdLevel::kAvx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case SimdLevel::kSse2:
+    return __builtin_cpu_supports("sse2");
+  default:
+    break;
+  }
+#endif
+  return level == SimdLevel::kScalar;
+}
+
+} // namespace
+
+SimdLevel DetectSimdLevel() { return SupportedSimdLevels().back(); }
+
+std::vector<SimdLevel> SupportedSimdLevels() {
+  std::vector<SimdLevel> result;
+  for (auto level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2,
+                     SimdLevel::kAvx512}) {
+    if (IsSupported(level)) {
+      result.push_back(level);
+    }
+  }
+  return result;
+}
+
+std::string SimdLevelName(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::kSse2:
+    return "sse2";
+  case SimdLevel::kAvx2:
+    return "avx2";
+  case SimdLevel::kAvx512:
+    return "avx512";
+  default:
+  case SimdLevel::kScalar:
+    return "scalar";
+  }
+}
+
+const VinogradKernels &GetVinogradKernels(SimdLevel level) {
+#ifdef S21_X86_KERNELS
+  switch (level) {
+  case SimdLevel::kSse2:
+    return kSse2Kernels;
+  case SimdLevel::kAvx2:
+    return kAvx2Kernels;
+  case SimdLevel::kAvx512:
+    return kAvx512Kernels;
+  default:
+    break;
+  }
+#endif
+  (void)level;
+  return kScalarKernels;
+}
+
+const VinogradKernels &DefaultVinogradKernels() {
+  static const VinogradKernels &kernels = []() -> const VinogradKernels & {
+    auto supported = SupportedSimdLevels();
+    const char *name = std::getenv("S21_SIMD");
+    for (auto level : supported) {
+      if (name != nullptr && SimdLevelName(level) == name) {
+        return GetVinogradKernels(level);
+      }
+    }
+    return GetVinogradKernels(supported.back());
+  }();
+  return kernels;
+}
+
+} // namespace s21
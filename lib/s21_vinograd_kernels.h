@@ -0,0 +1,76 @@
+#ifndef PARALLELS_SRC_LIB_S21_VINOGRAD_KERNELS_H_
+#define PARALLELS_SRC_LIB_S21_VINOGRAD_KERNELS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace s21 {
+
+/// @brief rows and columns of a micro-tile of BlockedVinograd
+constexpr std::size_t kVinogradMicroRows = 4;
+constexpr std::size_t kVinogradMicroCols = 8;
+
+/// @brief instruction set of Winograd kernels
+enum class SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+/// @brief inner loops of Winograd multiplication. Every instruction set has
+/// its own table; the best one supported by the CPU is chosen at runtime.
+/// Vector kernels may use FMA, so their results can differ from the scalar
+/// ones in the last bits.
+struct VinogradKernels {
+  SimdLevel level;
+
+  /// @brief returns sum of row[2k] * row[2k + 1] for k < pairs
+  double (*row_factor)(const double *row, std::size_t pairs);
+
+  /// @brief factor[j] += even[j] * odd[j] for j < cols
+  void (*col_factor)(const double *even, const double *odd, std::size_t cols,
+                     double *factor);
+
+  /// @brief computes one row of result:
+  /// res[j] = sum (a[2k] + b[2k + 1][j]) * (a[2k + 1] + b[2k][j])
+  ///          - row_factor - col_factor[j]
+  /// @param a row of the first matrix
+  /// @param b second matrix, row k starts at b + k * stride
+  /// @param stride distance between rows of b
+  /// @param pairs number of pairs of inner dimension
+  /// @param cols number of columns of the result
+  /// @param row_factor factor of the row of the first matrix
+  /// @param col_factor factors of the columns of the second matrix
+  /// @param res row of the result
+  void (*main_row)(const double *a, const double *b, std::size_t stride,
+                   std::size_t pairs, std::size_t cols, double row_factor,
+                   const double *col_factor, double *res);
+
+  /// @brief computes micro-tile kVinogradMicroRows x kVinogradMicroCols
+  /// over a packed micro-panel (see BlockedVinograd):
+  /// acc[r * kVinogradMicroCols + c] =
+  ///     sum (a[r][2k] + panel[k][0][c]) * (a[r][2k + 1] + panel[k][1][c])
+  /// @param a rows of the first matrix (all kVinogradMicroRows are read)
+  /// @param panel pairs x 2 x kVinogradMicroCols values
+  /// @param pairs number of pairs
+  /// @param acc result of size kVinogradMicroRows * kVinogradMicroCols
+  void (*micro_tile)(const double *const *a, const double *panel,
+                     std::size_t pairs, double *acc);
+};
+
+/// @brief best instruction set supported by the CPU
+SimdLevel DetectSimdLevel();
+
+/// @brief instruction sets supported by the CPU, from kScalar up
+std::vector<SimdLevel> SupportedSimdLevels();
+
+/// @brief name of instruction set ("scalar", "sse2", "avx2", "avx512")
+std::string SimdLevelName(SimdLevel level);
+
+/// @brief kernels for instruction set. It must be supported by the CPU
+const VinogradKernels &GetVinogradKernels(SimdLevel level);
+
+/// @brief kernels used by Vinograd engines: the best supported ones, or the
+/// ones named by S21_SIMD environment variable if it is supported
+const VinogradKernels &DefaultVinogradKernels();
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_VINOGRAD_KERNELS_H_
@@ -0,0 +1,153 @@
+#include "s21_vinograd_out_of_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
+#include "s21_vinograd_algorithms.h"
+
+namespace s21 {
+
+OutOfCoreVinograd::OutOfCoreVinograd(const std::string &first,
+                                     const std::string &second,
+                                     std::size_t budget, std::size_t t_num)
+    : first_(first), second_(second),
+      threads_num_(std::max<std::size_t>(t_num, 1)) {
+  if (first_.empty() || second_.empty() ||
+      first_.cols() != second_.rows()) {
+    throw "";
+  }
+  const double inner = static_cast<double>(first_.cols());
+  const double rows = static_cast<double>(first_.rows());
+  const double cols = static_cast<double>(second_.cols());
+  // two bands h x inner, two panels inner x w, the tile h x w and the row
+  // and column factors of ParallelVinograd (h + w):
+  // (2 * inner + 1) * (h + w) + h * w elements; square tiles h = w first
+  const double line = 2 * inner + 1;
+  const double elements = static_cast<double>(budget / sizeof(double));
+  double side = std::sqrt(line * line + elements) - line;
+  double h = std::min(std::floor(side), rows);
+  double w = std::floor((elements - line * h) / (line + h));
+  if (w > cols) {
+    // the whole width fits, the rest of the budget goes to the bands
+    w = cols;
+    h = std::min(std::floor((elements - line * w) / (line + w)), rows);
+  }
+  if (h < 1 || w < 1) {
+    throw "";
+  }
+  band_rows_ = static_cast<std::size_t>(h);
+  panel_cols_ = static_cast<std::size_t>(w);
+
+  // bytes read from the files in both orders of the loops
+  const double bands = std::ceil(rows / h);
+  const double panels = std::ceil(cols / w);
+  bands_outer_ = rows * inner + bands * inner * cols <=
+                 inner * cols + panels * rows * inner;
+}
+
+void OutOfCoreVinograd::Multiply(const std::string &result) {
+  const std::size_t rows = first_.rows();
+  const std::size_t cols = second_.cols();
+  const std::size_t bands = (rows + band_rows_ - 1) / band_rows_;
+  const std::size_t panels = (cols + panel_cols_ - 1) / panel_cols_;
+  std::vector<std::pair<std::size_t, std::size_t>> tiles;
+  for (std::size_t outer = 0; outer < (bands_outer_ ? bands : panels);
+       ++outer) {
+    for (std::size_t inner = 0; inner < (bands_outer_ ? panels : bands);
+         ++inner) {
+      tiles.emplace_back(bands_outer_ ? outer : inner,
+                         bands_outer_ ? inner : outer);
+    }
+  }
+
+  MatrixFileWriter<double> writer(result, rows, cols);
+  m_ptr band = std::make_shared<m_dbl_type>();
+  m_ptr panel = std::make_shared<m_dbl_type>();
+  m_ptr next_band = std::make_shared<m_dbl_type>();
+  m_ptr next_panel = std::make_shared<m_dbl_type>();
+  m_ptr tile = std::make_shared<m_dbl_type>();
+  LoadBand(0, *band);
+  LoadPanel(0, *panel);
+
+  for (std::size_t t = 0; t < tiles.size(); ++t) {
+    const auto [b, p] = tiles[t];
+    // the buffers of the next tile are filled by pool tasks while this one
+    // is multiplied; the group waits for them before unwinding as well
+    TaskGroup loads;
+    const bool load_band = t + 1 < tiles.size() && tiles[t + 1].first != b;
+    const bool load_panel = t + 1 < tiles.size() && tiles[t + 1].second != p;
+    if (load_band) {
+      loads.Run([&, t]() {
+        LoadBand(tiles[t + 1].first * band_rows_, *next_band);
+      });
+    }
+    if (load_panel) {
+      loads.Run([&, t]() {
+        LoadPanel(tiles[t + 1].second * panel_cols_, *next_panel);
+      });
+    }
+
+    if (tile->rows() != band->rows() || tile->cols() != panel->cols()) {
+      *tile = m_dbl_type(band->rows(), panel->cols());
+    }
+    ParallelVinograd(band, panel, tile, threads_num_).Multiply();
+    {
+      S21_TRACE_SCOPE("OutOfCoreWrite");
+      writer.WriteBlock(b * band_rows_, p * panel_cols_, tile->View());
+    }
+
+    loads.Wait();
+    if (load_band) {
+      std::swap(band, next_band);
+    }
+    if (load_panel) {
+      std::swap(panel, next_panel);
+    }
+  }
+}
+
+void OutOfCoreVinograd::LoadBand(std::size_t start, m_dbl_type &band) const {
+  S21_TRACE_SCOPE("OutOfCoreLoadBand");
+  const std::size_t end = std::min(start + band_rows_, first_.rows());
+  const std::size_t inner = first_.cols();
+  if (band.rows() != end - start) {
+    band = m_dbl_type(end - start, inner);
+  }
+  MatrixView<const double> first = first_.View();
+  first_.WillNeed(start, end);
+  for (std::size_t i = start; i < end; ++i) {
+    std::memcpy(band[i - start], &first(i, 0), inner * sizeof(double));
+  }
+  // the copy is used from now on, the mapped pages may be dropped
+  first_.DontNeed(start, end);
+}
+
+void OutOfCoreVinograd::LoadPanel(std::size_t start,
+                                  m_dbl_type &panel) const {
+  S21_TRACE_SCOPE("OutOfCoreLoadPanel");
+  const std::size_t end = std::min(start + panel_cols_, second_.cols());
+  const std::size_t inner = second_.rows();
+  if (panel.cols() != end - start) {
+    panel = m_dbl_type(inner, end - start);
+  }
+  MatrixView<const double> second = second_.View();
+  // a panel touches every row, rows are read and released in chunks
+  constexpr std::size_t kChunk = 256;
+  for (std::size_t k = 0; k < inner; k += kChunk) {
+    const std::size_t last = std::min(k + kChunk, inner);
+    second_.WillNeed(k, last);
+    for (std::size_t r = k; r < last; ++r) {
+      std::memcpy(panel[r], &second(r, start),
+                  (end - start) * sizeof(double));
+    }
+    second_.DontNeed(k, last);
+  }
+}
+
+} // namespace s21
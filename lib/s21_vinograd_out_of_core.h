@@ -0,0 +1,63 @@
+#ifndef PARALLELS_SRC_LIB_S21_VINOGRAD_OUT_OF_CORE_H_
+#define PARALLELS_SRC_LIB_S21_VINOGRAD_OUT_OF_CORE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "s21_matrix_file.h"
+#include "s21_types.h"
+
+namespace s21 {
+
+/// @brief Winograd multiplication of matrices larger than RAM. Operands are
+/// binary matrix files (see s21_matrix_file.h) mapped into memory; row bands
+/// of the first one and column panels of the second one are copied into
+/// buffers of a fixed memory budget, every band x panel tile of the result is
+/// multiplied by ParallelVinograd and written straight to the output file.
+/// The band and the panel of the next tile are loaded by pool tasks while
+/// the current tile is multiplied. The inner dimension is not split, so the
+/// budget must hold at least one row and one column of it (four of each with
+/// the prefetch buffers).
+class OutOfCoreVinograd {
+public:
+  /// @brief default memory budget of the buffers, bytes
+  static constexpr std::size_t kDefaultBudget = std::size_t{256} << 20;
+
+  /// @brief ctor. Maps the operands and derives sizes of the tiles
+  /// @param first path to the first matrix (double)
+  /// @param second path to the second matrix (double)
+  /// @param budget bytes of the bands, panels, the result tile and the row
+  /// and column factors of the tile
+  /// @param t_num number of threads multiplying a tile
+  /// @throw if the shapes do not match or the budget is too small
+  OutOfCoreVinograd(const std::string &first, const std::string &second,
+                    std::size_t budget = kDefaultBudget,
+                    std::size_t t_num = 1);
+  ~OutOfCoreVinograd() = default;
+
+  /// @brief multiplies the operands into the binary matrix file
+  /// @param result path to the result file, created or truncated
+  void Multiply(const std::string &result);
+
+  /// @brief rows of a band of the first matrix
+  std::size_t GetBandRows() const { return band_rows_; }
+  /// @brief columns of a panel of the second matrix
+  std::size_t GetPanelCols() const { return panel_cols_; }
+
+private:
+  MappedMatrix<double> first_;
+  MappedMatrix<double> second_;
+  std::size_t threads_num_;
+  std::size_t band_rows_;
+  std::size_t panel_cols_;
+  /// @brief bands in the outer loop: the first matrix is read once and the
+  /// second one once per band, otherwise the other way round
+  bool bands_outer_;
+
+  void LoadBand(std::size_t start, m_dbl_type &band) const;
+  void LoadPanel(std::size_t start, m_dbl_type &panel) const;
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_VINOGRAD_OUT_OF_CORE_H_
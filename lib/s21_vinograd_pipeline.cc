@@ -0,0 +1,152 @@
+#include "s21_vinograd_pipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "s21_thread_pool.h"
+#include "s21_trace.h"
+#include "s21_vinograd_algorithms.h"
+
+namespace s21 {
+
+/// @brief Winograd engine whose phases are called by different stages
+class StageVinograd : public SimpleVinograd {
+public:
+  using SimpleVinograd::BasicSimpleVinograd;
+
+  void ComputeFactors() {
+    ComputeRowFactor();
+    ComputeColFactor();
+  }
+
+  void MultiplyBand(std::size_t start, std::size_t end) {
+    MultiplyMainLoop(start, end);
+    if (f_cols_ % 2 != 0) {
+      AddBiasForOddRows(start, end);
+    }
+  }
+};
+
+/// @brief pair of matrices passing through the pipeline
+class PipelineJob {
+public:
+  std::size_t index;
+  const_m_ptr first;
+  const_m_ptr second;
+  m_ptr result;
+  std::unique_ptr<StageVinograd> engine;
+};
+
+VinogradPipeline::VinogradPipeline(Sink sink, std::size_t t_num,
+                                   std::size_t depth)
+    : sink_(std::move(sink)), threads_num_(std::max<std::size_t>(t_num, 1)),
+      load_queue_(depth), factor_queue_(depth), multiply_queue_(depth),
+      write_queue_(depth) {
+  if (!sink_) {
+    throw "";
+  }
+  stages_.emplace_back(&VinogradPipeline::RunStage, this,
+                       std::ref(load_queue_), &factor_queue_,
+                       &VinogradPipeline::Load);
+  stages_.emplace_back(&VinogradPipeline::RunStage, this,
+                       std::ref(factor_queue_), &multiply_queue_,
+                       &VinogradPipeline::ComputeFactors);
+  stages_.emplace_back(&VinogradPipeline::RunStage, this,
+                       std::ref(multiply_queue_), &write_queue_,
+                       &VinogradPipeline::MultiplyBands);
+  stages_.emplace_back(&VinogradPipeline::RunStage, this,
+                       std::ref(write_queue_), nullptr,
+                       &VinogradPipeline::WriteBack);
+}
+
+VinogradPipeline::~VinogradPipeline() { Stop(); }
+
+std::size_t VinogradPipeline::Submit(const_m_ptr first, const_m_ptr second) {
+  if (finished_ || !first || !second || first->empty() || second->empty() ||
+      first->cols() != second->rows()) {
+    throw "";
+  }
+  auto job = std::make_shared<PipelineJob>();
+  job->index = next_index_++;
+  job->first = std::move(first);
+  job->second = std::move(second);
+  load_queue_.Push(job);
+  return job->index;
+}
+
+void VinogradPipeline::Finish() {
+  Stop();
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void VinogradPipeline::Stop() {
+  finished_ = true;
+  // every stage closes the next queue when its input is drained
+  load_queue_.Close();
+  for (auto &stage : stages_) {
+    stage.join();
+  }
+  stages_.clear();
+}
+
+void VinogradPipeline::RunStage(
+    BoundedQueue<job_ptr> &input, BoundedQueue<job_ptr> *output,
+    void (VinogradPipeline::*stage)(PipelineJob &)) {
+  job_ptr job;
+  while (input.Pop(job)) {
+    // after an error the remaining pairs are drained without work
+    if (!failed_) {
+      try {
+        (this->*stage)(*job);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mtx_);
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+        failed_ = true;
+      }
+    }
+    if (output != nullptr && !failed_) {
+      output->Push(std::move(job));
+    }
+    job.reset();
+  }
+  if (output != nullptr) {
+    output->Close();
+  }
+}
+
+void VinogradPipeline::Load(PipelineJob &job) {
+  S21_TRACE_SCOPE("PipelineLoad");
+  job.result =
+      std::make_shared<m_dbl_type>(job.first->rows(), job.second->cols());
+  job.engine =
+      std::make_unique<StageVinograd>(job.first, job.second, job.result);
+  job.engine->SetKernels(*kernels_);
+}
+
+void VinogradPipeline::ComputeFactors(PipelineJob &job) {
+  job.engine->ComputeFactors();
+}
+
+void VinogradPipeline::MultiplyBands(PipelineJob &job) {
+  ParallelFor(0, job.result->rows(), threads_num_,
+              [&job](std::size_t start, std::size_t end) {
+                job.engine->MultiplyBand(start, end);
+              });
+}
+
+void VinogradPipeline::WriteBack(PipelineJob &job) {
+  S21_TRACE_SCOPE("PipelineWriteBack");
+  // the engine holds the inputs, release them before the sink runs
+  job.engine.reset();
+  job.first.reset();
+  job.second.reset();
+  sink_(job.index, std::move(*job.result));
+}
+
+} // namespace s21
@@ -0,0 +1,95 @@
+#ifndef PARALLELS_SRC_LIB_S21_VINOGRAD_PIPELINE_H_
+#define PARALLELS_SRC_LIB_S21_VINOGRAD_PIPELINE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "s21_bounded_queue.h"
+#include "s21_types.h"
+#include "s21_vinograd_kernels.h"
+
+namespace s21 {
+
+class PipelineJob;
+
+/// @brief Winograd multiplication of a stream of matrix pairs. Every pair
+/// passes four stages running in their own threads and connected by bounded
+/// queues:
+/// - load: checks shapes, allocates the result and the factors
+/// - factors: computes row and column factors
+/// - main loop: multiplies row bands of the pair in parallel on the pool
+/// - write-back: hands the result over to the sink
+/// so the factors of pair i + 1 are computed while pair i is multiplied and
+/// pair i - 1 is written back. Results reach the sink in submission order.
+class VinogradPipeline {
+public:
+  /// @brief receives results: index of the pair (see Submit) and its product
+  using Sink = std::function<void(std::size_t index, m_dbl_type result)>;
+
+  /// @brief ctor. Launches the stages
+  /// @param sink receiver of results, called from the write-back thread
+  /// @param t_num number of threads of the main loop
+  /// @param depth capacity of every queue between the stages
+  explicit VinogradPipeline(Sink sink, std::size_t t_num = 1,
+                            std::size_t depth = 2);
+  VinogradPipeline(const VinogradPipeline &other) = delete;
+  VinogradPipeline &operator=(const VinogradPipeline &other) = delete;
+  /// @brief finishes submitted pairs and stops the stages. Errors of the
+  /// stages are dropped, call Finish to get them
+  ~VinogradPipeline();
+
+  /// @brief enqueues pair for multiplication, waits while the load queue is
+  /// full. The matrices must not be changed until the result is written back
+  /// @param first first matrix
+  /// @param second second matrix
+  /// @return index of the pair passed to the sink
+  /// @throw if the pipeline is finished or the matrices can't be multiplied
+  std::size_t Submit(const_m_ptr first, const_m_ptr second);
+
+  /// @brief waits until all submitted pairs are written back and stops the
+  /// stages. Submit is not allowed afterwards
+  /// @throw first exception thrown by a stage or by the sink
+  void Finish();
+
+  /// @brief replaces inner loops, e.g. to compare instruction sets. Must be
+  /// called before the first Submit
+  /// @param kernels kernels supported by the CPU
+  void SetKernels(const VinogradKernels &kernels) { kernels_ = &kernels; }
+
+private:
+  using job_ptr = std::shared_ptr<PipelineJob>;
+
+  Sink sink_;
+  std::size_t threads_num_;
+  const VinogradKernels *kernels_ = &DefaultVinogradKernels();
+  std::size_t next_index_ = 0;
+  bool finished_ = false;
+
+  BoundedQueue<job_ptr> load_queue_;
+  BoundedQueue<job_ptr> factor_queue_;
+  BoundedQueue<job_ptr> multiply_queue_;
+  BoundedQueue<job_ptr> write_queue_;
+  std::vector<std::thread> stages_;
+
+  std::mutex error_mtx_;
+  std::exception_ptr error_;
+  std::atomic<bool> failed_{false};
+
+  void Stop();
+  void RunStage(BoundedQueue<job_ptr> &input, BoundedQueue<job_ptr> *output,
+                void (VinogradPipeline::*stage)(PipelineJob &));
+  void Load(PipelineJob &job);
+  void ComputeFactors(PipelineJob &job);
+  void MultiplyBands(PipelineJob &job);
+  void WriteBack(PipelineJob &job);
+};
+
+} // namespace s21
+
+#endif // PARALLELS_SRC_LIB_S21_VINOGRAD_PIPELINE_H_
@@ -1,15 +1,99 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "controller/s21_bench.h"
 #include "controller/s21_controller.h"
 #include "lib/s21_storage.h"
+#include "lib/s21_thread_pool.h"
+#include "lib/s21_trace.h"
 #include "view/s21_console_view.h"
 
-int main() {
+namespace {
+
+/// @brief configures pinning of pool workers, e.g. "compact:nosmt"
+/// @return false if description is not recognized
+bool ConfigureAffinity(const char *affinity) {
+  s21::Affinity mode = s21::Affinity::kNone;
+  bool use_smt = true;
+  if (!s21::Topology::ParseAffinity(affinity, mode, use_smt)) {
+    return false;
+  }
+  s21::ThreadPool::Instance().Configure(0, mode, use_smt);
+  return true;
+}
+
+/// @brief "Parallels bench ..." - non-interactive benchmark mode
+int RunBenchmark(int argc, const char *const *argv,
+                 std::shared_ptr<s21::Controller> controller) {
+  s21::BenchConfig config;
+  try {
+    config = s21::BenchConfig::Parse(argc, argv);
+  } catch (const std::invalid_argument &error) {
+    std::cerr << error.what() << '\n' << s21::BenchConfig::Usage();
+    return EXIT_FAILURE;
+  }
+  if (!config.affinity.empty() && !ConfigureAffinity(config.affinity.c_str())) {
+    std::cerr << "bench: unknown affinity '" << config.affinity << "'\n";
+    return EXIT_FAILURE;
+  }
+
+  if (!config.trace.empty()) {
+    s21::Trace::Enable();
+  }
+  std::vector<s21::BenchRecord> records;
+  try {
+    records = controller->RunBenchmark(config);
+  } catch (const std::exception &error) {
+    std::cerr << "bench: " << error.what() << '\n';
+    return EXIT_FAILURE;
+  } catch (...) {
+    std::cerr << "bench: computation failed\n";
+    return EXIT_FAILURE;
+  }
+  if (!config.trace.empty() && !s21::Trace::Dump(config.trace)) {
+    std::cerr << "bench: can not write " << config.trace << '\n';
+  }
+
+  if (config.output.empty()) {
+    s21::WriteBenchRecords(records, config.format, std::cout);
+    return EXIT_SUCCESS;
+  }
+  std::ofstream file(config.output);
+  s21::WriteBenchRecords(records, config.format, file);
+  return file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // optional pinning of worker threads, e.g. S21_AFFINITY=compact:nosmt
+  const char *affinity = std::getenv("S21_AFFINITY");
+  if (affinity != nullptr) {
+    ConfigureAffinity(affinity);
+  }
+  // optional Chrome trace of algorithm phases, e.g. S21_TRACE=trace.json
+  const char *trace = std::getenv("S21_TRACE");
+  if (trace != nullptr) {
+    s21::Trace::Enable();
+  }
 
   std::shared_ptr<s21::ConsoleView> view(new s21::ConsoleView());
   std::shared_ptr<s21::Controller> controller(new s21::Controller(view));
-  while (true) {
-    if (!controller->RecieveInitialSignal()) {
-      break;
+  int result = EXIT_SUCCESS;
+  if (argc > 1 && std::string(argv[1]) == "bench") {
+    result = RunBenchmark(argc - 2, argv + 2, controller);
+  } else {
+    while (true) {
+      if (!controller->RecieveInitialSignal()) {
+        break;
+      }
     }
   }
-  return 0;
+  if (trace != nullptr) {
+    s21::Trace::Dump(trace);
+  }
+  return result;
 }
@@ -1,12 +1,71 @@
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "controller/s21_bench.h"
+#include "lib/s21_random.h"
 #include "lib/s21_storage.h"
+#include "lib/s21_text_parser.h"
+#include "lib/s21_thread_pool.h"
+#include "lib/s21_topology.h"
+#include "lib/s21_trace.h"
 #include "lib/s21_types.h"
+#include "lib/s21_vinograd_out_of_core.h"
+#include "lib/s21_vinograd_pipeline.h"
 
 namespace s21 {
 
+/// @brief asserts the result to be the product of the matrices computed by
+/// the simple strategy
+void ExpectProductNear(const m_dbl_type &result, const m_dbl_type &first,
+                       const m_dbl_type &second) {
+  s21::VinogradStorage simple(first, second);
+  simple.SetStrategy(s21::Storage::MultiMode::kSimple);
+  simple.Multiply();
+  auto &expected = simple.GetResult();
+  ASSERT_EQ(result.rows(), expected.rows());
+  ASSERT_EQ(result.cols(), expected.cols());
+  for (std::size_t i = 0; i < expected.rows(); ++i) {
+    for (std::size_t j = 0; j < expected.cols(); ++j) {
+      ASSERT_NEAR(result(i, j), expected(i, j),
+                  1e-12 * std::fabs(expected(i, j)) + kEps);
+    }
+  }
+}
+
+/// @brief system n x (n + 1) solvable only with row pivoting: its leading
+/// element is zero
+m_dbl_type PivotingSle(std::size_t n) {
+  m_dbl_type matr(n, n + 1);
+  for (std::size_t i = 0; i < matr.rows(); ++i) {
+    for (std::size_t j = 0; j < matr.cols(); ++j) {
+      matr(i, j) = 1.0 / (i + j + 1) + (i == j ? 2.0 : 0.0) + (i * j) % 7;
+    }
+  }
+  matr(0, 0) = 0.0;
+  return matr;
+}
+
+/// @brief expects the solution of the storage to match the simple one
+void ExpectSolvesLike(const GaussStorage &simple, const GaussStorage &storage) {
+  auto &expected = simple.GetResult();
+  auto &result = storage.GetResult();
+  ASSERT_EQ(result.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(result.at(i), expected.at(i), kEps);
+  }
+}
+
 TEST(vinograd, aa) {
   for (int kk = 1; kk < 20; ++kk) {
     for (int p = 1; p < 20; ++p) {
@@ -316,6 +375,1333 @@ TEST(gauss, extreme_2) {
   }
 }
 
+TEST(matrix, creation) {
+  m_dbl_type matr = {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+  EXPECT_EQ(matr.rows(), 2u);
+  EXPECT_EQ(matr.cols(), 3u);
+  EXPECT_EQ(matr.stride() % (m_dbl_type::kAlignment / sizeof(double)), 0u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(matr[1]) %
+                m_dbl_type::kAlignment,
+            0u);
+  EXPECT_EQ(matr(1, 2), 6.0);
+  EXPECT_EQ(matr.at(0).at(1), 2.0);
+  EXPECT_THROW(matr.at(2, 0), std::out_of_range);
+  EXPECT_THROW(matr.at(0).at(3), std::out_of_range);
+  EXPECT_THROW(m_dbl_type({{1.0, 2.0}, {3.0}}), std::invalid_argument);
+}
+
+TEST(matrix, copy_and_move) {
+  m_dbl_type matr(3, 3, 1.5);
+  m_dbl_type copy = matr;
+  copy(0, 0) = 2.0;
+  EXPECT_EQ(matr(0, 0), 1.5);
+  m_dbl_type moved = std::move(copy);
+  EXPECT_EQ(moved(0, 0), 2.0);
+  EXPECT_TRUE(copy.empty());
+  moved.SwapRows(0, 2);
+  EXPECT_EQ(moved(2, 0), 2.0);
+  EXPECT_EQ(moved(0, 0), 1.5);
+}
+
+TEST(matrix, views) {
+  m_dbl_type matr = {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}, {7.0, 8.0, 9.0}};
+  auto block = matr.Block(1, 1, 2, 2);
+  EXPECT_EQ(block(0, 0), 5.0);
+  EXPECT_EQ(block(1, 1), 9.0);
+  block(0, 1) = -6.0;
+  EXPECT_EQ(matr(1, 2), -6.0);
+  auto transposed = matr.View().Transposed();
+  EXPECT_EQ(transposed(0, 2), 7.0);
+  EXPECT_EQ(transposed.Row(1)[0], 2.0);
+  EXPECT_EQ(matr.View().Col(0).at(2), 7.0);
+  EXPECT_THROW(matr.Block(2, 2, 2, 1), std::out_of_range);
+}
+
+TEST(matrix, binary_file) {
+  std::string filename = ::testing::TempDir() + "s21_matrix_binary.bin";
+  m_dbl_type matr = s21::Storage::FillMatrixRandomly(7, 13);
+  s21::Storage::SaveMatrixBinary(matr, filename);
+  EXPECT_TRUE(s21::IsMatrixFile(filename));
+
+  m_dbl_type loaded = s21::Storage::FillMatrixFromFile(filename);
+  ASSERT_EQ(loaded.rows(), 7u);
+  ASSERT_EQ(loaded.cols(), 13u);
+  for (std::size_t i = 0; i < matr.rows(); ++i) {
+    for (std::size_t j = 0; j < matr.cols(); ++j) {
+      ASSERT_EQ(matr(i, j), loaded(i, j));
+    }
+  }
+
+  // mapping is private: changes do not reach the file
+  loaded(0, 0) = -1.0;
+  m_dbl_type reloaded = s21::Storage::LoadMatrixBinary(filename);
+  EXPECT_EQ(reloaded(0, 0), matr(0, 0));
+  EXPECT_THROW(s21::LoadMatrix<float>(filename), std::runtime_error);
+
+  // payload offsets and alignments that would give a misaligned view
+  const std::uint64_t headers[][2] = {{72, 64}, {68, 4}, {64, 0}, {32, 32}};
+  for (auto &fields : headers) {
+    {
+      std::fstream file(filename,
+                        std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(offsetof(s21::MatrixFileHeader, alignment));
+      file.write(reinterpret_cast<const char *>(&fields[1]), 8);
+      file.seekp(offsetof(s21::MatrixFileHeader, payload_offset));
+      file.write(reinterpret_cast<const char *>(&fields[0]), 8);
+    }
+    EXPECT_THROW(s21::LoadMatrix<double>(filename), std::runtime_error);
+    EXPECT_THROW(s21::MappedMatrix<double>{filename}, std::runtime_error);
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(matrix, binary_result) {
+  std::string filename = ::testing::TempDir() + "s21_gauss_result.bin";
+  m_dbl_type matr = {{1.0, 2.0, 3.0}, {2.0, 3.0, 1.0}};
+  s21::GaussStorage storage(matr);
+  storage.SetStrategy(s21::Storage::MultiMode::kSimple);
+  storage.SolveSle();
+  storage.SaveResult(filename);
+  m_dbl_type loaded = s21::Storage::LoadMatrixBinary(filename);
+  ASSERT_EQ(loaded.rows(), 1u);
+  ASSERT_EQ(loaded.cols(), 2u);
+  EXPECT_NEAR(loaded(0, 0), -7.0, kEps);
+  EXPECT_NEAR(loaded(0, 1), 5.0, kEps);
+  std::remove(filename.c_str());
+}
+
+TEST(parser, layouts) {
+  s21::TextParser parser;
+  m_dbl_type csv = parser.ParseText("1.5, -2;3e2\n+4,5,6\r\n\n");
+  m_dbl_type expected = {{1.5, -2.0, 300.0}, {4.0, 5.0, 6.0}};
+  ASSERT_EQ(csv.rows(), 2u);
+  ASSERT_EQ(csv.cols(), 3u);
+  for (std::size_t i = 0; i < expected.rows(); ++i) {
+    for (std::size_t j = 0; j < expected.cols(); ++j) {
+      EXPECT_EQ(csv(i, j), expected(i, j));
+    }
+  }
+  m_dbl_type ws = parser.ParseText("1.5\t-2 300\n4 5 6");
+  EXPECT_EQ(ws(0, 2), 300.0);
+  EXPECT_EQ(ws(1, 2), 6.0);
+  EXPECT_THROW(parser.ParseText("1 2\n3"), std::runtime_error);
+  EXPECT_THROW(parser.ParseText("1,2\n3 4", s21::TextParser::Shape::kTable,
+                                s21::TextParser::Layout::kWhitespace),
+               std::runtime_error);
+  EXPECT_THROW(parser.ParseText("1 2x"), std::runtime_error);
+}
+
+TEST(parser, shapes) {
+  s21::TextParser parser;
+  m_dbl_type square = parser.ParseText("2\n1 2 3\n4");
+  ASSERT_EQ(square.rows(), 2u);
+  EXPECT_EQ(square(1, 0), 3.0);
+
+  m_dbl_type sle = parser.ParseText("2\n1 2 3\n4 5 6\n");
+  ASSERT_EQ(sle.rows(), 2u);
+  ASSERT_EQ(sle.cols(), 3u);
+  EXPECT_EQ(sle(1, 2), 6.0);
+
+  m_dbl_type headless = parser.ParseText("1,2,3\n4,5,6",
+                                         s21::TextParser::Shape::kSle);
+  s21::GaussStorage storage(headless);
+  storage.SetStrategy(s21::Storage::MultiMode::kSimple);
+  storage.SolveSle();
+  EXPECT_NEAR(storage.GetResult().at(0), -1.0, kEps);
+  EXPECT_NEAR(storage.GetResult().at(1), 2.0, kEps);
+  EXPECT_THROW(parser.ParseText("1 2\n3 4", s21::TextParser::Shape::kSle),
+               std::runtime_error);
+
+  // single columns are tables, whatever the first value is
+  for (const char *text : {"0\n5\n3", "2\n5\n3", "2.5\n5\n3"}) {
+    SCOPED_TRACE(text);
+    m_dbl_type column = parser.ParseText(text);
+    ASSERT_EQ(column.rows(), 3u);
+    ASSERT_EQ(column.cols(), 1u);
+    EXPECT_EQ(column(1, 0), 5.0);
+    EXPECT_EQ(column(2, 0), 3.0);
+  }
+}
+
+TEST(parser, blocks_and_threads) {
+  std::string filename = ::testing::TempDir() + "s21_parser_big.txt";
+  m_dbl_type matr = s21::Storage::FillMatrixRandomly(300, 301);
+  {
+    std::ofstream file(filename);
+    file.precision(17);
+    for (std::size_t i = 0; i < matr.rows(); ++i) {
+      for (std::size_t j = 0; j < matr.cols(); ++j) {
+        file << matr(i, j) << (j + 1 == matr.cols() ? "\n" : ",");
+      }
+    }
+  }
+  m_dbl_type parsed = s21::TextParser(4, 100000).ParseFile(filename);
+  ASSERT_EQ(parsed.rows(), matr.rows());
+  ASSERT_EQ(parsed.cols(), matr.cols());
+  for (std::size_t i = 0; i < matr.rows(); ++i) {
+    for (std::size_t j = 0; j < matr.cols(); ++j) {
+      ASSERT_EQ(parsed(i, j), matr(i, j));
+    }
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(thread_pool, task_group) {
+  s21::ThreadPool pool(3);
+  std::atomic<int> counter(0);
+  s21::TaskGroup group(pool);
+  for (int i = 0; i < 100; ++i) {
+    group.Run([&counter, &pool]() {
+      s21::TaskGroup nested(pool);
+      for (int j = 0; j < 10; ++j) {
+        nested.Run([&counter]() { ++counter; });
+      }
+      nested.Wait();
+    });
+  }
+  group.Wait();
+  EXPECT_EQ(counter, 1000);
+
+  group.Run([]() { throw std::runtime_error("task failed"); });
+  EXPECT_THROW(group.Wait(), std::runtime_error);
+  EXPECT_NO_THROW(group.Wait());
+}
+
+TEST(thread_pool, barrier) {
+  constexpr std::size_t kTeam = 4;
+  constexpr std::size_t kSteps = 50;
+  s21::Barrier barrier(kTeam);
+  std::vector<std::size_t> counters(kTeam, 0);
+  std::atomic<bool> ok{true};
+  auto worker = [&](std::size_t id) {
+    for (std::size_t step = 0; step < kSteps; ++step) {
+      counters[id] = step + 1;
+      barrier.ArriveAndWait();
+      // all threads finished the step before anyone starts the next one
+      for (std::size_t other = 0; other < kTeam; ++other) {
+        if (counters[other] < step + 1) {
+          ok = false;
+        }
+      }
+      barrier.ArriveAndWait();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t id = 1; id < kTeam; ++id) {
+    threads.emplace_back(worker, id);
+  }
+  worker(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(ok);
+}
+
+TEST(thread_pool, team) {
+  constexpr std::size_t kTeam = 3;
+  s21::ThreadTeam team(kTeam);
+  EXPECT_EQ(team.Size(), kTeam);
+  std::vector<std::thread::id> first_run(kTeam);
+  for (int run = 0; run < 5; ++run) {
+    std::vector<std::thread::id> members(kTeam);
+    s21::Barrier barrier(kTeam);
+    team.Run([&](std::size_t id) {
+      members[id] = std::this_thread::get_id();
+      // all members run at the same time
+      barrier.ArriveAndWait();
+    });
+    EXPECT_EQ(members[0], std::this_thread::get_id());
+    if (run == 0) {
+      first_run = members;
+    }
+    // the threads are started once
+    EXPECT_EQ(members, first_run);
+  }
+  auto failing = [](std::size_t id) {
+    if (id == kTeam - 1) {
+      throw std::runtime_error("fail");
+    }
+  };
+  EXPECT_THROW(team.Run(failing), std::runtime_error);
+  std::atomic<std::size_t> calls{0};
+  team.Run([&calls](std::size_t) { ++calls; });
+  EXPECT_EQ(calls, kTeam);
+}
+
+TEST(thread_pool, task_graph) {
+  // diamond chains: task 3k + 1 and 3k + 2 depend on 3k, 3k + 3 on both
+  constexpr std::size_t kChains = 20;
+  s21::TaskGraph graph;
+  std::vector<std::atomic<int>> done(3 * kChains + 1);
+  std::atomic<bool> ok{true};
+  auto task = [&](std::size_t id, std::vector<std::size_t> dependencies) {
+    return graph.Add(
+        [&, id, dependencies]() {
+          for (std::size_t dependency : dependencies) {
+            if (done[dependency] != 1) {
+              ok = false;
+            }
+          }
+          ++done[id];
+        },
+        dependencies);
+  };
+  task(0, {});
+  for (std::size_t k = 0; k < kChains; ++k) {
+    task(3 * k + 1, {3 * k});
+    task(3 * k + 2, {3 * k});
+    task(3 * k + 3, {3 * k + 1, 3 * k + 2});
+  }
+  EXPECT_EQ(graph.Size(), 3 * kChains + 1);
+  EXPECT_THROW(graph.Add([]() {}, {graph.Size()}), const char *);
+
+  for (std::size_t threads : {1, 4}) {
+    for (auto &value : done) {
+      value = 0;
+    }
+    graph.Run(threads);
+    EXPECT_TRUE(ok);
+    for (auto &value : done) {
+      EXPECT_EQ(value, 1);
+    }
+  }
+
+  // tasks depending on a failed one are skipped
+  s21::TaskGraph failing;
+  bool skipped = true;
+  auto first = failing.Add([]() { throw std::runtime_error("fail"); });
+  failing.Add([&skipped]() { skipped = false; }, {first});
+  EXPECT_THROW(failing.Run(2), std::runtime_error);
+  EXPECT_TRUE(skipped);
+}
+
+TEST(thread_pool, parallel_for) {
+  std::vector<int> marks(1001, 0);
+  s21::ParallelFor(1, marks.size(), 7, [&marks](std::size_t start,
+                                                 std::size_t end) {
+    for (std::size_t i = start; i < end; ++i) {
+      ++marks[i];
+    }
+  });
+  EXPECT_EQ(marks[0], 0);
+  EXPECT_TRUE(std::all_of(marks.begin() + 1, marks.end(),
+                          [](int mark) { return mark == 1; }));
+}
+
+TEST(gauss, parallel_matches_simple) {
+  m_dbl_type matr = PivotingSle(60);
+  s21::GaussStorage simple(matr);
+  simple.SetStrategy(s21::Storage::MultiMode::kSimple);
+  simple.SolveSle();
+  s21::GaussStorage parallel(matr);
+  parallel.SetThreadCount(4);
+  parallel.SetStrategy(s21::Storage::MultiMode::kParallel);
+  for (int i = 0; i < 5; ++i) {
+    parallel.SolveSle();
+  }
+  ExpectSolvesLike(simple, parallel);
+}
+
+TEST(gauss, blocked_lu) {
+  // zero leading element needs pivoting during elimination
+  m_dbl_type matr = PivotingSle(70);
+  s21::GaussStorage simple(matr);
+  simple.SetStrategy(s21::Storage::MultiMode::kSimple);
+  simple.SolveSle();
+
+  s21::GaussStorage blocked(matr);
+  blocked.SetThreadCount(
+      std::min<std::size_t>(3, s21::Storage::MaxThreadCount()));
+  for (std::size_t block : {1, 7, 32, 0, 100}) {
+    SCOPED_TRACE(block);
+    blocked.SetBlock(block);
+    blocked.SetStrategy(s21::Storage::MultiMode::kBlocked);
+    for (int i = 0; i < 2; ++i) {
+      blocked.SolveSle();
+    }
+    ExpectSolvesLike(simple, blocked);
+  }
+
+  m_dbl_type singular = {
+      {1.0, 1.0, 1.0, 2.0}, {0.0, 1.0, -3.0, 1.0}, {2.0, 1.0, 5.0, 0.0}};
+  s21::GaussStorage storage(singular);
+  storage.SetStrategy(s21::Storage::MultiMode::kBlocked);
+  EXPECT_THROW(storage.SolveSle(), std::runtime_error);
+}
+
+TEST(gauss, tiled_lu) {
+  // zero leading element needs pivoting across tiles
+  m_dbl_type matr = PivotingSle(70);
+  s21::GaussStorage simple(matr);
+  simple.SetStrategy(s21::Storage::MultiMode::kSimple);
+  simple.SolveSle();
+
+  s21::GaussStorage tiled(matr);
+  for (std::size_t threads : {1, 3}) {
+    tiled.SetThreadCount(
+        std::min<std::size_t>(threads, s21::Storage::MaxThreadCount()));
+    for (std::size_t tile : {1, 7, 32, 0, 100}) {
+      SCOPED_TRACE(tile);
+      tiled.SetTile(tile);
+      tiled.SetStrategy(s21::Storage::MultiMode::kTiled);
+      for (int i = 0; i < 2; ++i) {
+        tiled.SolveSle();
+      }
+      ExpectSolvesLike(simple, tiled);
+    }
+  }
+
+  // 3 tiles: 3 panels, 3 + 2 + 1 row tasks, 3 * 2 + 2 * 1 updates
+  auto input = std::make_shared<const m_dbl_type>(matr);
+  auto output = std::make_shared<row_type>(matr.cols(), 1.0);
+  s21::TiledGauss engine(input, output, 1, 24);
+  EXPECT_EQ(engine.GetTile(), 24u);
+  EXPECT_EQ(engine.GetTaskCount(), 17u);
+
+  m_dbl_type singular = {
+      {1.0, 1.0, 1.0, 2.0}, {0.0, 1.0, -3.0, 1.0}, {2.0, 1.0, 5.0, 0.0}};
+  s21::GaussStorage storage(singular);
+  storage.SetTile(2);
+  storage.SetStrategy(s21::Storage::MultiMode::kTiled);
+  EXPECT_THROW(storage.SolveSle(), std::runtime_error);
+}
+
+TEST(gauss, parallel_pivoting) {
+  // large enough for a team of 6 (ParallelGauss gives 32 rows to a member)
+  // elimination without pivoting would divide by zero
+  m_dbl_type matr = PivotingSle(200);
+  s21::GaussStorage simple(matr);
+  simple.SetStrategy(s21::Storage::MultiMode::kSimple);
+  simple.SolveSle();
+  for (std::size_t threads : {1, 2, 3, 6}) {
+    SCOPED_TRACE(threads);
+    s21::GaussStorage parallel(matr);
+    parallel.SetThreadCount(threads);
+    parallel.SetStrategy(s21::Storage::MultiMode::kParallel);
+    parallel.SolveSle();
+    ExpectSolvesLike(simple, parallel);
+  }
+
+  m_dbl_type singular = {
+      {-3.0, -5.0, 36.0, 10.0}, {-1.0, 0.0, 7.0, 5.0}, {1.0, 1.0, -10.0, -4.0}};
+  s21::GaussStorage storage(singular);
+  storage.SetThreadCount(2);
+  storage.SetStrategy(s21::Storage::MultiMode::kParallel);
+  EXPECT_THROW(storage.SolveSle(), std::runtime_error);
+}
+
+TEST(gauss, solve_many) {
+  const std::size_t n = 50;
+  m_dbl_type matr = s21::MatrixGenerator(9).DiagonallyDominant(n);
+  s21::GaussStorage storage(matr);
+  storage.SetThreadCount(
+      std::min<std::size_t>(3, s21::Storage::MaxThreadCount()));
+  storage.SetStrategy(s21::Storage::MultiMode::kSimple);
+  storage.SolveSle();
+
+  // the right-hand side of the SLE gives the same solution
+  row_type b(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    b[i] = matr(i, n);
+  }
+  row_type x = storage.Solve(b);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(x[i], storage.GetResult()[i], kEps);
+  }
+
+  m_dbl_type rhs = s21::Storage::FillMatrixRandomly(n, 13, 10);
+  m_dbl_type solutions = storage.Solve(rhs);
+  ASSERT_EQ(solutions.rows(), n);
+  ASSERT_EQ(solutions.cols(), 13u);
+  for (std::size_t c = 0; c < rhs.cols(); ++c) {
+    row_type column(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      column[i] = rhs(i, c);
+    }
+    row_type single = storage.Solve(column);
+    for (std::size_t i = 0; i < n; ++i) {
+      EXPECT_NEAR(solutions(i, c), single[i], kEps);
+      // residual of A x = b
+      double sum = 0.0;
+      for (std::size_t j = 0; j < n; ++j) {
+        sum += matr(i, j) * solutions(j, c);
+      }
+      EXPECT_NEAR(sum, rhs(i, c), 1e-6 * std::fabs(rhs(i, c)) + kEps);
+    }
+  }
+  EXPECT_THROW(storage.Solve(row_type(n + 1)), const char *);
+  EXPECT_THROW(storage.Solve(m_dbl_type(n - 1, 2)), const char *);
+
+  m_dbl_type singular = {
+      {1.0, 1.0, 1.0, 2.0}, {0.0, 1.0, -3.0, 1.0}, {2.0, 1.0, 5.0, 0.0}};
+  s21::GaussStorage singular_storage(singular);
+  EXPECT_THROW(singular_storage.Solve(row_type(3, 1.0)), std::runtime_error);
+}
+
+TEST(gauss, workspace) {
+  const std::size_t n = 40;
+  const m_dbl_type matr = s21::MatrixGenerator(5).DiagonallyDominant(n);
+  auto input = std::make_shared<const m_dbl_type>(matr);
+  auto result = std::make_shared<row_type>(n + 1, 1.0);
+  auto workspace = std::make_shared<s21::GaussWorkspace>();
+  const double *buffer = workspace->GetMatrix(n, n + 1).data();
+
+  s21::SimpleGauss simple(input, result, workspace);
+  s21::ParallelGauss parallel(input, result, 2, workspace);
+  s21::BlockedGauss blocked(input, result, 2, 8, workspace);
+  row_type expected;
+  for (s21::Gauss *engine :
+       std::initializer_list<s21::Gauss *>{&simple, &parallel, &blocked}) {
+    for (int repeat = 0; repeat < 2; ++repeat) {
+      result->assign(n + 1, 1.0);
+      engine->SolveSle();
+      if (expected.empty()) {
+        expected = *result;
+      }
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR((*result)[i], expected[i], kEps);
+      }
+      // the engines work in the same buffer, the input is not changed
+      EXPECT_EQ(workspace->GetMatrix(n, n + 1).data(), buffer);
+      for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j <= n; ++j) {
+          ASSERT_EQ((*input)(i, j), matr(i, j));
+        }
+      }
+    }
+  }
+
+  // a failed elimination does not change the input either
+  const m_dbl_type singular = {
+      {1.0, 1.0, 1.0, 2.0}, {0.0, 1.0, -3.0, 1.0}, {2.0, 1.0, 5.0, 0.0}};
+  auto singular_input = std::make_shared<const m_dbl_type>(singular);
+  auto singular_result = std::make_shared<row_type>(4, 1.0);
+  s21::SimpleGauss failing(singular_input, singular_result);
+  EXPECT_THROW(failing.SolveSle(), std::runtime_error);
+  for (std::size_t i = 0; i < singular.rows(); ++i) {
+    for (std::size_t j = 0; j < singular.cols(); ++j) {
+      EXPECT_EQ((*singular_input)(i, j), singular(i, j));
+    }
+  }
+}
+
+TEST(topology, placement) {
+  // 2 packages x 2 cores x 2 SMT siblings, siblings are cpu and cpu + 4
+  std::vector<s21::CpuInfo> cpus;
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    s21::CpuInfo info;
+    info.cpu = cpu;
+    info.package = (cpu % 4) / 2;
+    info.core = cpu % 2;
+    info.smt = cpu / 4;
+    cpus.push_back(info);
+  }
+  s21::Topology topology(cpus);
+  EXPECT_EQ(topology.Placement(s21::Affinity::kCompact),
+            std::vector<int>({0, 4, 1, 5, 2, 6, 3, 7}));
+  EXPECT_EQ(topology.Placement(s21::Affinity::kCompact, false),
+            std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(topology.Placement(s21::Affinity::kScatter),
+            std::vector<int>({0, 2, 1, 3, 4, 6, 5, 7}));
+  EXPECT_EQ(topology.Placement(s21::Affinity::kScatter, false),
+            std::vector<int>({0, 2, 1, 3}));
+
+  s21::Affinity mode = s21::Affinity::kNone;
+  bool use_smt = true;
+  EXPECT_TRUE(s21::Topology::ParseAffinity("scatter:nosmt", mode, use_smt));
+  EXPECT_EQ(mode, s21::Affinity::kScatter);
+  EXPECT_FALSE(use_smt);
+  EXPECT_FALSE(s21::Topology::ParseAffinity("spread", mode, use_smt));
+}
+
+TEST(thread_pool, configure) {
+  s21::ThreadPool pool(2);
+  pool.Configure(3, s21::Affinity::kCompact);
+  EXPECT_EQ(pool.Size(), 3u);
+  std::atomic<int> counter(0);
+  s21::TaskGroup group(pool);
+  for (int i = 0; i < 10; ++i) {
+    group.Run([&counter]() { ++counter; });
+  }
+  group.Wait();
+  EXPECT_EQ(counter, 10);
+
+  // a team pinned like the workers: member id runs on the CPU of worker id
+  s21::ThreadTeam team(2, pool.Cpus());
+  EXPECT_EQ(team.Cpus(), pool.Cpus());
+  if (!pool.Cpus().empty()) {
+    int cpu = -1;
+    team.Run([&cpu](std::size_t id) {
+      if (id == 1) {
+        cpu = sched_getcpu();
+      }
+    });
+    EXPECT_EQ(cpu, pool.Cpus()[1 % pool.Cpus().size()]);
+  }
+}
+
+TEST(storage, thread_count) {
+  m_dbl_type matr = {{1.0, 2.0, 3.0}, {2.0, 3.0, 1.0}};
+  s21::GaussStorage storage(matr);
+  EXPECT_NO_THROW(storage.SetThreadCount(0));
+  EXPECT_NO_THROW(storage.SetThreadCount(s21::Storage::MaxThreadCount()));
+  EXPECT_THROW(storage.SetThreadCount(s21::Storage::MaxThreadCount() + 1),
+               const char *);
+  s21::VinogradStorage vinograd(matr, s21::Storage::FillMatrixRandomly(3, 2));
+  EXPECT_NO_THROW(vinograd.SetThreadCount(s21::Storage::MaxThreadCount()));
+  vinograd.SetStrategy(s21::Storage::MultiMode::kParallel);
+  EXPECT_NO_THROW(vinograd.Multiply());
+  // Gauss-only mode does not leave the storage without an engine
+  EXPECT_THROW(vinograd.SetStrategy(s21::Storage::MultiMode::kTiled),
+               const char *);
+  EXPECT_THROW(vinograd.SetStrategy(s21::Storage::MultiMode::kEnd),
+               const char *);
+}
+
+TEST(storage, ownership) {
+  auto first = std::make_shared<const m_dbl_type>(
+      m_dbl_type{{1.0, 2.0}, {3.0, 4.0}});
+  auto second = std::make_shared<const m_dbl_type>(
+      m_dbl_type{{5.0, 6.0}, {7.0, 8.0}});
+  s21::VinogradStorage storage(first, second);
+  EXPECT_EQ(first.use_count(), 2);
+  storage.SetStrategy(s21::Storage::MultiMode::kSimple);
+  storage.Multiply();
+  const m_dbl_type &view = storage.GetResult();
+  EXPECT_DOUBLE_EQ(view(0, 0), 19.0);
+  m_dbl_type taken = storage.TakeResult();
+  EXPECT_DOUBLE_EQ(taken(1, 1), 50.0);
+  storage.Multiply();
+  EXPECT_DOUBLE_EQ(storage.GetResult()(1, 0), 43.0);
+
+  m_dbl_type matr = {{2.0, 1.0, 3.0}, {1.0, -1.0, 0.0}};
+  s21::GaussStorage gauss(std::move(matr));
+  gauss.SetStrategy(s21::Storage::MultiMode::kSimple);
+  gauss.SolveSle();
+  auto solution = gauss.TakeResult();
+  EXPECT_NEAR(solution.at(0), 1.0, kEps);
+  EXPECT_NEAR(solution.at(1), 1.0, kEps);
+  gauss.SolveSle();
+  EXPECT_NEAR(gauss.GetResult().at(0), 1.0, kEps);
+  EXPECT_TRUE(matr.empty());
+  EXPECT_THROW(s21::VinogradStorage(s21::const_m_ptr(), second), const char *);
+}
+
+TEST(random, philox) {
+  s21::Philox::Counter expected = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                   0x9b00dbd8};
+  EXPECT_EQ(s21::Philox::Generate({0, 0, 0, 0}, {0, 0}), expected);
+}
+
+TEST(random, reproducible) {
+  auto one = s21::MatrixGenerator(42, 1).Generate(37, 23);
+  auto many = s21::MatrixGenerator(42, 5).Generate(37, 23);
+  auto other = s21::MatrixGenerator(43, 5).Generate(37, 23);
+  bool rows_differ = false;
+  for (std::size_t i = 0; i < one.rows(); ++i) {
+    for (std::size_t j = 0; j < one.cols(); ++j) {
+      EXPECT_EQ(one(i, j), many(i, j));
+      EXPECT_NE(one(i, j), other(i, j));
+      EXPECT_GE(one(i, j), 0.0);
+      EXPECT_LT(one(i, j), 1.0);
+      rows_differ = rows_differ || one(i, j) != one(0, j);
+    }
+  }
+  EXPECT_TRUE(rows_differ);
+  auto storage = s21::Storage::FillMatrixRandomly(5, 4, 7);
+  EXPECT_EQ(storage(4, 3), s21::Storage::FillMatrixRandomly(5, 4, 7)(4, 3));
+}
+
+TEST(random, shapes) {
+  s21::MatrixGenerator generator(1);
+  generator.SetDistribution(s21::MatrixGenerator::Distribution::kInteger, -5,
+                            5);
+  auto integers = generator.Generate(10, 10);
+  for (std::size_t i = 0; i < 10; ++i) {
+    for (std::size_t j = 0; j < 10; ++j) {
+      EXPECT_EQ(integers(i, j), std::floor(integers(i, j)));
+      EXPECT_LE(std::fabs(integers(i, j)), 5.0);
+    }
+  }
+
+  auto sle = generator.DiagonallyDominant(50);
+  for (std::size_t i = 0; i < 50; ++i) {
+    double sum = 0.0;
+    for (std::size_t j = 0; j < 50; ++j) {
+      sum += (i == j) ? 0.0 : std::fabs(sle(i, j));
+    }
+    EXPECT_GT(sle(i, i), sum);
+  }
+  s21::GaussStorage gauss(std::move(sle));
+  gauss.SetStrategy(s21::Storage::MultiMode::kSimple);
+  EXPECT_NO_THROW(gauss.SolveSle());
+
+  generator.SetDistribution(s21::MatrixGenerator::Distribution::kNormal, 10,
+                            2);
+  auto weights = generator.SymmetricWeights(20);
+  for (std::size_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(weights(i, i), 0.0);
+    for (std::size_t j = 0; j < 20; ++j) {
+      EXPECT_EQ(weights(i, j), weights(j, i));
+      EXPECT_GE(weights(i, j), 0.0);
+    }
+  }
+  EXPECT_THROW(generator.SetDistribution(
+                   s21::MatrixGenerator::Distribution::kUniform, 1, 0),
+               std::invalid_argument);
+}
+
+TEST(trace, chrome_export) {
+  s21::Trace::Clear();
+  s21::Trace::Enable();
+  s21::VinogradStorage storage(s21::Storage::FillMatrixRandomly(8, 5, 1),
+                               s21::Storage::FillMatrixRandomly(5, 8, 2));
+  storage.SetStrategy(s21::Storage::MultiMode::kParallel);
+  storage.Multiply();
+  m_dbl_type sle = {{2.0, 1.0, 3.0}, {1.0, -1.0, 0.0}};
+  s21::GaussStorage gauss(std::move(sle));
+  gauss.SetStrategy(s21::Storage::MultiMode::kSimple);
+  gauss.SolveSle();
+  s21::Trace::Enable(false);
+  storage.Multiply();
+
+  std::ostringstream out;
+  s21::Trace::WriteChromeJson(out);
+  std::string json = out.str();
+  for (const char *phase :
+       {"ComputeRowFactor", "ComputeColFactor", "MultiplyMainLoop",
+        "AddBiasForOddRows", "LeadToEchelon", "AdjustEchelon",
+        "CheckEchelon", "BackPropagation"}) {
+    EXPECT_NE(json.find(std::string("\"") + phase + "\""),
+              std::string::npos);
+  }
+  EXPECT_EQ(json.find("traceEvents"), 2u);
+  std::size_t events = s21::Trace::Size();
+  EXPECT_GT(events, 0u);
+
+  s21::Trace::Clear();
+  std::thread writer([]() {
+    for (std::size_t i = 0; i < s21::Trace::kBufferSize + 10; ++i) {
+      s21::Trace::Record("event", 0, 1);
+    }
+  });
+  writer.join();
+  EXPECT_EQ(s21::Trace::Size(), s21::Trace::kBufferSize);
+  s21::Trace::Clear();
+
+  // buffers of exited threads are reused, their events are kept
+  const std::size_t buffers = s21::Trace::BufferCount();
+  for (int i = 0; i < 20; ++i) {
+    std::thread([]() { s21::Trace::Record("short", 0, 1); }).join();
+  }
+  EXPECT_LE(s21::Trace::BufferCount(), buffers + 1);
+  EXPECT_EQ(s21::Trace::Size(), 20u);
+  s21::Trace::Clear();
+}
+
+TEST(vinograd, blocked_matches_simple) {
+  const std::size_t shapes[][3] = {{1, 1, 1},   {5, 1, 7},   {13, 2, 9},
+                                   {17, 33, 23}, {40, 64, 8}, {9, 101, 31}};
+  const s21::BlockedVinograd::Tiles tiles[] = {{}, {4, 8, 3}, {5, 13, 1}};
+  for (auto &shape : shapes) {
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[0], shape[1], 3));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 4));
+    for (auto &tile : tiles) {
+      s21::VinogradStorage blocked(first, second);
+      blocked.SetTiles(tile);
+      blocked.SetStrategy(s21::Storage::MultiMode::kBlocked);
+      blocked.Multiply();
+      ExpectProductNear(blocked.GetResult(), *first, *second);
+    }
+  }
+}
+
+TEST(vinograd, blocked_tiles) {
+  s21::CacheSizes caches;
+  caches.l1 = 48 << 10;
+  caches.l2 = 2 << 20;
+  caches.l3 = 32 << 20;
+  auto tiles = s21::BlockedVinograd::AdjustTiles({}, caches);
+  EXPECT_EQ(tiles.pairs, 192u);
+  EXPECT_EQ(tiles.rows % s21::BlockedVinograd::kMicroRows, 0u);
+  EXPECT_EQ(tiles.cols % s21::BlockedVinograd::kMicroCols, 0u);
+  EXPECT_LE(tiles.rows * tiles.pairs * 2 * sizeof(double), caches.l2 / 2);
+  EXPECT_LE(tiles.cols * tiles.pairs * 2 * sizeof(double), caches.l3 / 2);
+  tiles = s21::BlockedVinograd::AdjustTiles({6, 3, 2}, caches);
+  EXPECT_EQ(tiles.rows, 4u);
+  EXPECT_EQ(tiles.cols, s21::BlockedVinograd::kMicroCols);
+  EXPECT_EQ(tiles.pairs, 2u);
+  EXPECT_GT(s21::Topology::Instance().Caches().l1, 0u);
+}
+
+TEST(vinograd, simd_kernels) {
+  auto &scalar = s21::GetVinogradKernels(s21::SimdLevel::kScalar);
+  auto near = [](double value, double expected) {
+    return std::fabs(value - expected) <= 1e-12 * std::fabs(expected) + kEps;
+  };
+  // odd sizes exercise vector tails of every instruction set
+  const std::size_t sizes[] = {1, 2, 3, 7, 8, 15, 17, 33, 64, 70};
+  for (auto level : s21::SupportedSimdLevels()) {
+    SCOPED_TRACE(s21::SimdLevelName(level));
+    auto &kernels = s21::GetVinogradKernels(level);
+    EXPECT_EQ(kernels.level, level);
+    for (std::size_t size : sizes) {
+      SCOPED_TRACE(size);
+      auto a = s21::Storage::FillMatrixRandomly(2 * size, 2 * size, size);
+      const double *row = a[0];
+      EXPECT_PRED2(near, kernels.row_factor(row, size),
+                   scalar.row_factor(row, size));
+
+      row_type factor(2 * size, 1.0);
+      row_type expected(2 * size, 1.0);
+      kernels.col_factor(a[0], a[1], 2 * size, factor.data());
+      scalar.col_factor(a[0], a[1], 2 * size, expected.data());
+      for (std::size_t j = 0; j < 2 * size; ++j) {
+        EXPECT_PRED2(near, factor[j], expected[j]);
+      }
+
+      row_type res(2 * size);
+      kernels.main_row(a[1], a.data(), a.stride(), size, 2 * size, 3.0,
+                       factor.data(), res.data());
+      scalar.main_row(a[1], a.data(), a.stride(), size, 2 * size, 3.0,
+                      factor.data(), expected.data());
+      for (std::size_t j = 0; j < 2 * size; ++j) {
+        EXPECT_PRED2(near, res[j], expected[j]);
+      }
+
+      const double *rows[s21::kVinogradMicroRows];
+      for (std::size_t r = 0; r < s21::kVinogradMicroRows; ++r) {
+        rows[r] = a[r % a.rows()];
+      }
+      auto panel = s21::Storage::FillMatrixRandomly(
+          1, 2 * s21::kVinogradMicroCols * size, size + 1);
+      constexpr std::size_t tile =
+          s21::kVinogradMicroRows * s21::kVinogradMicroCols;
+      double acc[tile];
+      double expected_acc[tile];
+      kernels.micro_tile(rows, panel[0], size, acc);
+      scalar.micro_tile(rows, panel[0], size, expected_acc);
+      for (std::size_t i = 0; i < tile; ++i) {
+        EXPECT_PRED2(near, acc[i], expected_acc[i]);
+      }
+    }
+  }
+}
+
+TEST(vinograd, parallel_tiles) {
+  // tall, wide, odd-width and single-row results, derived and given tiles
+  const std::size_t shapes[][5] = {{3, 16, 200, 0, 0},  {200, 9, 3, 0, 0},
+                                   {1, 7, 1000, 0, 0},  {37, 41, 29, 5, 7},
+                                   {64, 64, 64, 64, 1}, {10, 3, 10, 100, 100}};
+  for (auto &shape : shapes) {
+    SCOPED_TRACE(shape[2]);
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[0], shape[1], 7));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 8));
+    for (std::size_t threads : {1, 3, 8}) {
+      auto result = std::make_shared<m_dbl_type>(shape[0], shape[2]);
+      s21::ParallelVinograd engine(first, second, result, threads, shape[3],
+                                   shape[4]);
+      EXPECT_LE(engine.GetTileRows(), shape[0]);
+      EXPECT_LE(engine.GetTileCols(), shape[2]);
+      // the second run restarts the tile counter
+      for (int run = 0; run < 2; ++run) {
+        result->Fill(0.0);
+        engine.Multiply();
+        ExpectProductNear(*result, *first, *second);
+      }
+    }
+  }
+  // a short and wide result is split on columns as well
+  auto first = std::make_shared<const m_dbl_type>(2, 4, 1.0);
+  auto second = std::make_shared<const m_dbl_type>(4, 1024, 1.0);
+  auto result = std::make_shared<m_dbl_type>(2, 1024);
+  s21::ParallelVinograd engine(first, second, result, 8);
+  EXPECT_EQ(engine.GetTileRows(), 1u);
+  EXPECT_LT(engine.GetTileCols(), 1024u);
+  EXPECT_EQ(engine.GetTileCols() % s21::kVinogradMicroCols, 0u);
+}
+
+TEST(vinograd, pipe_bands) {
+  const std::size_t shapes[][3] = {{1, 1, 1}, {50, 17, 30}, {7, 64, 3}};
+  for (auto &shape : shapes) {
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[0], shape[1], 9));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 10));
+    for (std::size_t threads : {1, 4}) {
+      s21::VinogradStorage pipe(first, second);
+      pipe.SetThreadCount(threads);
+      pipe.SetStrategy(s21::Storage::MultiMode::kPipe);
+      pipe.Multiply();
+      ExpectProductNear(pipe.GetResult(), *first, *second);
+    }
+  }
+}
+
+TEST(vinograd, pipeline_stream) {
+  // pairs of different shapes, more of them than the queues can hold
+  const std::size_t pairs = 12;
+  std::vector<const_m_ptr> firsts;
+  std::vector<const_m_ptr> seconds;
+  for (std::size_t i = 0; i < pairs; ++i) {
+    firsts.push_back(std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(5 + i, 3 + i % 4, i)));
+    seconds.push_back(std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(3 + i % 4, 9 - i % 3, i + 100)));
+  }
+
+  std::vector<std::size_t> order;
+  std::vector<m_dbl_type> results(pairs);
+  s21::VinogradPipeline pipeline(
+      [&order, &results](std::size_t index, m_dbl_type result) {
+        order.push_back(index);
+        results[index] = std::move(result);
+      },
+      3, 1);
+  for (std::size_t i = 0; i < pairs; ++i) {
+    EXPECT_EQ(pipeline.Submit(firsts[i], seconds[i]), i);
+  }
+  EXPECT_THROW(pipeline.Submit(firsts[0], firsts[1]), const char *);
+  pipeline.Finish();
+  EXPECT_THROW(pipeline.Submit(firsts[0], seconds[0]), const char *);
+
+  ASSERT_EQ(order.size(), pairs);
+  for (std::size_t i = 0; i < pairs; ++i) {
+    EXPECT_EQ(order[i], i);
+    ExpectProductNear(results[i], *firsts[i], *seconds[i]);
+  }
+
+  // an error of the sink is rethrown by Finish, the rest is drained
+  s21::VinogradPipeline failing([](std::size_t index, m_dbl_type) {
+    if (index == 1) {
+      throw std::runtime_error("sink");
+    }
+  });
+  for (std::size_t i = 0; i < 4; ++i) {
+    failing.Submit(firsts[i], seconds[i]);
+  }
+  EXPECT_THROW(failing.Finish(), std::runtime_error);
+}
+
+TEST(vinograd, batch_shared_operand) {
+  // odd and even inner dimensions, products wider than a micro-panel
+  const std::size_t shapes[][3] = {{6, 9, 13}, {3, 8, 20}, {17, 1, 5}};
+  for (auto &shape : shapes) {
+    SCOPED_TRACE(shape[1]);
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[0], shape[1], 11));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 12));
+    std::vector<const_m_ptr> firsts;
+    std::vector<const_m_ptr> seconds;
+    for (std::size_t i = 0; i < 5; ++i) {
+      firsts.push_back(std::make_shared<const m_dbl_type>(
+          s21::Storage::FillMatrixRandomly(shape[0] + i, shape[1], 20 + i)));
+      seconds.push_back(std::make_shared<const m_dbl_type>(
+          s21::Storage::FillMatrixRandomly(shape[1], shape[2] + i, 30 + i)));
+    }
+
+    // one thread per matrix and several threads per matrix (bands)
+    for (std::size_t threads : {1, 4, 16}) {
+      s21::VinogradStorage storage(first, second);
+      storage.SetThreadCount(
+          std::min(threads, s21::Storage::MaxThreadCount()));
+      for (int run = 0; run < 2; ++run) {
+        auto right = storage.MultiplyBatch(firsts);
+        auto left = storage.MultiplyByBatch(seconds);
+        ASSERT_EQ(right.size(), firsts.size());
+        ASSERT_EQ(left.size(), seconds.size());
+        for (std::size_t i = 0; i < firsts.size(); ++i) {
+          ExpectProductNear(right[i], *firsts[i], *second);
+          ExpectProductNear(left[i], *first, *seconds[i]);
+        }
+      }
+      EXPECT_TRUE(storage.MultiplyBatch({}).empty());
+      EXPECT_THROW(storage.MultiplyBatch({second}), const char *);
+    }
+
+    s21::BatchVinograd engine(second);
+    m_dbl_type result;
+    engine.Multiply(*first, result);
+    ExpectProductNear(result, *first, *second);
+  }
+}
+
+TEST(vinograd, incremental_update) {
+  for (std::size_t inner : {20, 21}) {
+    SCOPED_TRACE(inner);
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(30, inner, 13));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(inner, 25, 14));
+    m_dbl_type first_copy = *first;
+    m_dbl_type second_copy = *second;
+    s21::VinogradStorage storage(first, second);
+    storage.SetIncrementalThreshold(0.2);
+    storage.SetThreadCount(
+        std::min<std::size_t>(3, s21::Storage::MaxThreadCount()));
+    storage.SetStrategy(s21::Storage::MultiMode::kBlocked);
+    storage.Multiply();
+    EXPECT_FALSE(storage.LastUpdateWasIncremental());
+
+    // two ticks below the threshold (incremental) and one above it (full)
+    const std::size_t changes[] = {2, 4, 10};
+    for (std::size_t tick = 0; tick < 3; ++tick) {
+      SCOPED_TRACE(tick);
+      auto rows = s21::Storage::FillMatrixRandomly(changes[tick], inner, tick);
+      auto cols = s21::Storage::FillMatrixRandomly(changes[tick], inner,
+                                                   tick + 50);
+      for (std::size_t c = 0; c < changes[tick]; ++c) {
+        std::size_t i = (7 * c + tick) % first_copy.rows();
+        std::size_t j = (5 * c + 2 * tick) % second_copy.cols();
+        row_type row(rows[c], rows[c] + inner);
+        row_type col(cols[c], cols[c] + inner);
+        storage.SetFirstRow(i, row);
+        storage.SetSecondCol(j, col);
+        std::copy(row.begin(), row.end(), first_copy[i]);
+        for (std::size_t k = 0; k < inner; ++k) {
+          second_copy(k, j) = col[k];
+        }
+      }
+      storage.Multiply();
+      EXPECT_EQ(storage.LastUpdateWasIncremental(), tick < 2);
+
+      ExpectProductNear(storage.GetResult(), first_copy, second_copy);
+    }
+    // the matrices of the caller are not changed
+    EXPECT_NE((*first)(0, 0), first_copy(0, 0));
+    EXPECT_THROW(storage.SetFirstRow(30, row_type(inner)), const char *);
+    EXPECT_THROW(storage.SetSecondCol(0, row_type(inner + 1)), const char *);
+  }
+}
+
+TEST(vinograd, element_types) {
+  const std::size_t threads =
+      std::min<std::size_t>(3, s21::Storage::MaxThreadCount());
+  const s21::Storage::MultiMode modes[] = {s21::Storage::MultiMode::kSimple,
+                                           s21::Storage::MultiMode::kParallel,
+                                           s21::Storage::MultiMode::kPipe};
+  for (std::size_t inner : {16, 17}) {
+    SCOPED_TRACE(inner);
+    Matrix<std::int64_t> first(19, inner);
+    Matrix<std::int64_t> second(inner, 23);
+    for (std::size_t i = 0; i < first.rows(); ++i) {
+      for (std::size_t k = 0; k < inner; ++k) {
+        first(i, k) = static_cast<std::int64_t>(i * 7 + k * 3) % 21 - 10;
+      }
+    }
+    for (std::size_t k = 0; k < inner; ++k) {
+      for (std::size_t j = 0; j < second.cols(); ++j) {
+        second(k, j) = static_cast<std::int64_t>(k * 5 + j * 11) % 17 - 8;
+      }
+    }
+    Matrix<std::int64_t> expected(first.rows(), second.cols());
+    Matrix<float> first_f(first.rows(), inner);
+    Matrix<float> second_f(inner, second.cols());
+    for (std::size_t i = 0; i < first.rows(); ++i) {
+      for (std::size_t k = 0; k < inner; ++k) {
+        first_f(i, k) = static_cast<float>(first(i, k)) / 4;
+        for (std::size_t j = 0; j < second.cols(); ++j) {
+          expected(i, j) += first(i, k) * second(k, j);
+        }
+      }
+    }
+    for (std::size_t k = 0; k < inner; ++k) {
+      for (std::size_t j = 0; j < second.cols(); ++j) {
+        second_f(k, j) = static_cast<float>(second(k, j)) / 4;
+      }
+    }
+
+    s21::BasicVinogradStorage<std::int64_t> storage(first, second);
+    s21::BasicVinogradStorage<float> storage_f(first_f, second_f);
+    storage.SetThreadCount(threads);
+    storage_f.SetThreadCount(threads);
+    for (auto mode : modes) {
+      SCOPED_TRACE(static_cast<int>(mode));
+      storage.SetStrategy(mode);
+      storage.Multiply();
+      storage_f.SetStrategy(mode);
+      storage_f.Multiply();
+      auto &result = storage.GetResult();
+      auto &result_f = storage_f.GetResult();
+      for (std::size_t i = 0; i < expected.rows(); ++i) {
+        for (std::size_t j = 0; j < expected.cols(); ++j) {
+          ASSERT_EQ(result(i, j), expected(i, j));
+          // values are multiples of 1/16, sums of them are exact in float
+          ASSERT_EQ(result_f(i, j), static_cast<float>(expected(i, j)) / 16);
+        }
+      }
+    }
+    EXPECT_THROW(storage_f.SetStrategy(s21::Storage::MultiMode::kBlocked),
+                 const char *);
+    EXPECT_THROW(storage.MultiplyBatch({}), const char *);
+  }
+}
+
+TEST(vinograd, out_of_core) {
+  const std::string dir = ::testing::TempDir();
+  const std::string first_file = dir + "s21_ooc_first.bin";
+  const std::string second_file = dir + "s21_ooc_second.bin";
+  const std::string result_file = dir + "s21_ooc_result.bin";
+  // tall and wide shapes take the two orders of the loops
+  const std::size_t shapes[][3] = {{37, 21, 29}, {10, 20, 53}};
+  for (auto &shape : shapes) {
+    SCOPED_TRACE(shape[0]);
+    m_dbl_type first = s21::Storage::FillMatrixRandomly(shape[0], shape[1], 3);
+    m_dbl_type second =
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 4);
+    s21::SaveMatrix(first, first_file);
+    s21::SaveMatrix(second, second_file);
+
+    // room for bands and panels of about 8 rows and columns
+    const std::size_t budget = (4 * shape[1] * 8 + 64) * sizeof(double);
+    s21::OutOfCoreVinograd engine(
+        first_file, second_file, budget,
+        std::min<std::size_t>(2, s21::Storage::MaxThreadCount()));
+    EXPECT_LT(engine.GetBandRows(), shape[0]);
+    EXPECT_LT(engine.GetPanelCols(), shape[2]);
+    engine.Multiply(result_file);
+    ExpectProductNear(s21::LoadMatrix<double>(result_file), first, second);
+    EXPECT_THROW(s21::OutOfCoreVinograd(first_file, second_file,
+                                        4 * shape[1] * sizeof(double)),
+                 const char *);
+  }
+  EXPECT_THROW(s21::OutOfCoreVinograd(first_file, first_file), const char *);
+  EXPECT_THROW(s21::OutOfCoreVinograd(dir + "s21_ooc_missing.bin",
+                                      second_file),
+               std::runtime_error);
+  std::remove(first_file.c_str());
+  std::remove(second_file.c_str());
+  std::remove(result_file.c_str());
+}
+
+TEST(vinograd, sparse) {
+  // about 3% of nonzeros, odd shapes
+  auto sparsify = [](m_dbl_type matrix) {
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+      for (std::size_t j = 0; j < matrix.cols(); ++j) {
+        if ((i * 31 + j * 17) % 32 != 0) {
+          matrix(i, j) = 0.0;
+        }
+      }
+    }
+    return matrix;
+  };
+  m_dbl_type first = sparsify(s21::Storage::FillMatrixRandomly(41, 37, 5));
+  m_dbl_type second = sparsify(s21::Storage::FillMatrixRandomly(37, 45, 6));
+  m_dbl_type dense = s21::Storage::FillMatrixRandomly(37, 45, 7);
+  EXPECT_LE(s21::Density(first), s21::SparseVinograd::kSparseDensity);
+
+  auto check = [&first, &second](const m_dbl_type &result) {
+    ExpectProductNear(result, first, second);
+  };
+
+  const std::size_t threads =
+      std::min<std::size_t>(3, s21::Storage::MaxThreadCount());
+  auto a = s21::CsrMatrix::FromDense(first);
+  auto b = s21::CsrMatrix::FromDense(second);
+  check(s21::MultiplySparse(a, b, threads).ToDense());
+  m_dbl_type result(first.rows(), second.cols());
+  s21::MultiplySparseDense(a, second, result, threads);
+  check(result);
+  s21::MultiplyDenseSparse(first, b, result, threads);
+  check(result);
+  m_dbl_type transposed = a.Transposed().ToDense();
+  for (std::size_t i = 0; i < first.rows(); ++i) {
+    for (std::size_t j = 0; j < first.cols(); ++j) {
+      ASSERT_EQ(transposed(j, i), first(i, j));
+    }
+  }
+
+  // sparse x sparse, sparse x dense and dense x dense through the storage
+  for (auto mode :
+       {s21::Storage::MultiMode::kSparse, s21::Storage::MultiMode::kAuto}) {
+    s21::VinogradStorage storage(first, second);
+    storage.SetThreadCount(threads);
+    storage.SetStrategy(mode);
+    storage.Multiply();
+    check(storage.GetResult());
+  }
+  s21::VinogradStorage mixed(first, dense);
+  mixed.SetStrategy(s21::Storage::MultiMode::kSparse);
+  mixed.Multiply();
+  ExpectProductNear(mixed.GetResult(), first, dense);
+  EXPECT_FALSE(s21::SparseVinograd::IsSparse(dense, dense));
+  EXPECT_THROW(s21::BasicVinogradStorage<float>(Matrix<float>(2, 2),
+                                                Matrix<float>(2, 2))
+                   .SetStrategy(s21::Storage::MultiMode::kSparse),
+               const char *);
+}
+
+TEST(vinograd, sparse_updates) {
+  const std::size_t n = 40;
+  m_dbl_type first(n, n);
+  m_dbl_type second(n, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    first(i, i) = 1.0;
+    second(i, i) = 2.0;
+  }
+  for (auto mode :
+       {s21::Storage::MultiMode::kSparse, s21::Storage::MultiMode::kAuto}) {
+    s21::VinogradStorage storage(first, second);
+    storage.SetStrategy(mode);
+    storage.Multiply();
+    // enough rows for a full Multiply, which must see the new values
+    for (std::size_t i = 0; i < 10; ++i) {
+      row_type row(n, 0.0);
+      row[i + 5] = 1.0;
+      storage.SetFirstRow(i, row);
+    }
+    storage.Multiply();
+    for (std::size_t i = 0; i < 10; ++i) {
+      EXPECT_EQ(storage.GetResult()(i, i + 5), 2.0);
+      EXPECT_EQ(storage.GetResult()(i, i), 0.0);
+    }
+    EXPECT_EQ(storage.GetResult()(20, 20), 2.0);
+
+    for (std::size_t j = 0; j < 10; ++j) {
+      storage.SetSecondCol(j, row_type(n, 3.0));
+    }
+    storage.Multiply();
+    EXPECT_EQ(storage.GetResult()(0, 0), 3.0);
+    EXPECT_EQ(storage.GetResult()(20, 9), 3.0);
+    EXPECT_EQ(storage.GetResult()(20, 20), 2.0);
+  }
+}
+
+TEST(sparse, matrix_market) {
+  std::string filename = ::testing::TempDir() + "s21_matrix_market.mtx";
+  {
+    std::ofstream file(filename);
+    file << "%%MatrixMarket matrix coordinate real symmetric\n"
+            "% lower triangle of a symmetric matrix\n"
+            "3 3 4\n"
+            "1 1 2.5\n"
+            "2 1 -1\n"
+            "3 2 4\n"
+            "3 3 1e1\n";
+  }
+  s21::CsrMatrix matrix = s21::LoadMatrixMarket(filename);
+  EXPECT_EQ(matrix.rows(), 3u);
+  EXPECT_EQ(matrix.nnz(), 6u);
+  m_dbl_type expected = {{2.5, -1, 0}, {-1, 0, 4}, {0, 4, 10}};
+  m_dbl_type dense = matrix.ToDense();
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      EXPECT_EQ(dense(i, j), expected(i, j));
+    }
+  }
+  {
+    std::ofstream file(filename);
+    file << "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n";
+  }
+  EXPECT_THROW(s21::LoadMatrixMarket(filename), std::runtime_error);
+  std::remove(filename.c_str());
+  EXPECT_THROW(s21::LoadMatrixMarket(filename), std::runtime_error);
+  EXPECT_THROW(s21::CsrMatrix(2, 2, {0, 1, 1}, {0, 1}, {1.0, 2.0}),
+               const char *);
+}
+
+TEST(vinograd, strassen_matches_simple) {
+  // square, padded odd sizes and rectangular shapes, 1 to 3 levels
+  const std::size_t shapes[][4] = {{8, 8, 8, 4},      {37, 41, 29, 8},
+                                   {64, 64, 64, 8},   {50, 17, 70, 4},
+                                   {33, 100, 12, 5},  {3, 3, 3, 1},
+                                   {16, 16, 16, 100}, {75, 60, 90, 16}};
+  for (auto &shape : shapes) {
+    SCOPED_TRACE(shape[0]);
+    auto first = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[0], shape[1], 5));
+    auto second = std::make_shared<const m_dbl_type>(
+        s21::Storage::FillMatrixRandomly(shape[1], shape[2], 6));
+    for (std::size_t threads : {1, 4}) {
+      s21::VinogradStorage strassen(first, second);
+      strassen.SetStrassenCutoff(shape[3]);
+      strassen.SetThreadCount(threads);
+      strassen.SetStrategy(s21::Storage::MultiMode::kStrassen);
+      // the second run reuses padded copies and scratch memory
+      for (int run = 0; run < 2; ++run) {
+        strassen.Multiply();
+        ExpectProductNear(strassen.GetResult(), *first, *second);
+      }
+    }
+  }
+}
+
+TEST(vinograd, strassen_depth) {
+  // depth is driven by the smallest dimension (90)
+  auto first = std::make_shared<const m_dbl_type>(100, 300, 1.0);
+  auto second = std::make_shared<const m_dbl_type>(300, 90, 1.0);
+  auto result = std::make_shared<m_dbl_type>(100, 90);
+  EXPECT_EQ(s21::StrassenVinograd(first, second, result, 100).GetDepth(), 0u);
+  EXPECT_EQ(s21::StrassenVinograd(first, second, result, 45).GetDepth(), 1u);
+  EXPECT_EQ(s21::StrassenVinograd(first, second, result, 12).GetDepth(), 3u);
+
+  s21::StrassenVinograd engine(first, second, result, 12);
+  engine.Multiply();
+  for (std::size_t i = 0; i < result->rows(); ++i) {
+    for (std::size_t j = 0; j < result->cols(); ++j) {
+      ASSERT_DOUBLE_EQ((*result)(i, j), 300.0);
+    }
+  }
+}
+
+TEST(bench, parse) {
+  auto parse = [](std::vector<const char *> args) {
+    return s21::BenchConfig::Parse(static_cast<int>(args.size()),
+                                   args.data());
+  };
+  auto config = parse({});
+  EXPECT_EQ(config.algorithm, s21::BenchConfig::Algorithm::kVinograd);
+  EXPECT_EQ(config.modes.size(), 2u);
+  EXPECT_EQ(config.sizes, std::vector<std::size_t>{256});
+  EXPECT_EQ(config.threads, std::vector<std::size_t>{0});
+  EXPECT_EQ(config.block, 0u);
+
+  config = parse({"--algo", "gauss", "--mode", "simple,tiled", "--sizes",
+                  "256:4096:x2", "--threads", "1,2", "--tiles", "8,16,32",
+                  "--block", "16", "--tile", "32", "--format", "json"});
+  EXPECT_EQ(config.algorithm, s21::BenchConfig::Algorithm::kGauss);
+  ASSERT_EQ(config.modes.size(), 2u);
+  EXPECT_EQ(config.modes[1], s21::Storage::MultiMode::kTiled);
+  EXPECT_EQ(config.sizes,
+            (std::vector<std::size_t>{256, 512, 1024, 2048, 4096}));
+  EXPECT_EQ(config.threads, (std::vector<std::size_t>{1, 2}));
+  EXPECT_EQ(config.tiles.rows, 8u);
+  EXPECT_EQ(config.tiles.cols, 16u);
+  EXPECT_EQ(config.tiles.pairs, 32u);
+  EXPECT_EQ(config.block, 16u);
+  EXPECT_EQ(config.tile, 32u);
+  EXPECT_EQ(config.format, s21::BenchConfig::Format::kJson);
+  EXPECT_EQ(parse({"--sizes", "64:256:+64"}).sizes,
+            (std::vector<std::size_t>{64, 128, 192, 256}));
+  EXPECT_EQ(parse({"--sizes", "100,200"}).sizes,
+            (std::vector<std::size_t>{100, 200}));
+
+  for (std::vector<const char *> bad :
+       {std::vector<const char *>{"--sizes"},
+        {"--sizes", "0:64:x2"},
+        {"--sizes", "16:64:x1"},
+        {"--sizes", "16:64"},
+        {"--sizes", "16,-2"},
+        {"--threads", "two"},
+        {"--tiles", "8,16"},
+        {"--block", "-1"},
+        {"--mode", "fast"},
+        {"--algo", "salesman", "--mode", "blocked"},
+        {"--mode", "tiled"},
+        {"--algo", "vinograd", "--mode", "simple,tiled"},
+        {"--reps", "0"},
+        {"--format", "xml"},
+        {"--unknown", "1"}}) {
+    EXPECT_THROW(parse(bad), std::invalid_argument);
+  }
+}
+
 } // namespace s21
 
 int main(int argc, char **argv) {
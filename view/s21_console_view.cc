@@ -1,7 +1,9 @@
 #include "s21_console_view.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 
 namespace s21 {
 
@@ -105,13 +107,11 @@ int ConsoleView::GetIterationsCount() const {
 }
 
 int ConsoleView::GetThreadsCount() const {
+  int max_count = Storage::MaxThreadCount();
   int count = -1;
-  while (
-      !(count == 0 || count == 1 || count == 2 || count == 4 || count == 6)) {
-    count = GetUserChoice("Введите число потоков:\n");
-    if (count % 2 != 0) {
-      ShowMsg("Число потоков должно быть четным.");
-    }
+  while (count < 0 || count > max_count) {
+    count = GetUserChoice("Введите число потоков (от 1 до " +
+                          std::to_string(max_count) + ", 0 для выхода):\n");
   }
   return count;
 }
@@ -146,6 +146,7 @@ void ConsoleView::DisplayGaussMenu() const {
   std::cout << "Алгорим Гаусса" << std::endl;
   std::cout << "1. Ввести матрицу" << std::endl;
   std::cout << "2. Сгенерировать случайную матрицу" << std::endl;
+  std::cout << "3. Загрузить матрицу из файла" << std::endl;
   std::cout << "0. Выход" << std::endl << std::endl;
 }
 
@@ -207,11 +208,14 @@ m_dbl_type UserFiller::FillMatrix() {
   view_->ShowMsg("Введите матрицу:");
   auto rows = view_->GetUserChoice("Введите число строк");
   auto cols = view_->GetUserChoice("Введите число столбцов");
-  std::vector<std::vector<double>> matrix;
+  if (rows <= 0 || cols <= 0) {
+    return m_dbl_type();
+  }
+  m_dbl_type matrix(rows, cols);
   for (int i = 0; i < rows; ++i) {
     view_->ShowMsg("Заполните ряд");
     std::vector<double> one_row = view_->GetVector(cols);
-    matrix.push_back(one_row);
+    std::copy(one_row.begin(), one_row.end(), matrix[i]);
   }
   return matrix;
 }
@@ -68,9 +68,9 @@ public:
   /// @brief returns non negative integer number from user
   /// @return integer number
   int GetIterationsCount() const;
-  /// @brief returns non negative integer number from user (0, 1 or multiple of
-  /// 2)
-  /// @return integer number: 0, 1, 2, 4 or 6
+  /// @brief returns non negative integer number from user, not greater than
+  /// Storage::MaxThreadCount()
+  /// @return integer number, 0 if user wants to quit
   int GetThreadsCount() const;
   /// @brief just shows the message
   /// @param msg - message
@@ -79,11 +79,10 @@ public:
   /// @brief just output the matrix. It is responsibility of developer to check
   /// that type T has methods for stream output
   /// @param result - matrix to output
-  template <typename T>
-  void ShowMatrix(const std::vector<std::vector<T>> &result) const {
-    for (auto &row : result) {
-      for (auto &value : row) {
-        std::cout << value << " ";
+  template <typename T> void ShowMatrix(const Matrix<T> &result) const {
+    for (std::size_t i = 0; i < result.rows(); ++i) {
+      for (std::size_t j = 0; j < result.cols(); ++j) {
+        std::cout << result(i, j) << " ";
       }
       std::cout << std::endl;
     }